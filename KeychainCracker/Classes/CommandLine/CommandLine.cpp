@@ -0,0 +1,1177 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        CommandLine.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "CommandLine.hpp"
+#include "CompiledWordList.hpp"
+#include "CompiledWordListSource.hpp"
+#include "WordListStream.hpp"
+#include "PasswordVariants.hpp"
+#include "KeychainCracker.hpp"
+#include "MarkovModel.hpp"
+#include "KeychainTarget.hpp"
+#include "KeychainVerifier.hpp"
+#include "JobScheduler.hpp"
+#include "DaemonServer.hpp"
+#include "AttackPlanner.hpp"
+#include "RunJournal.hpp"
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <stdexcept>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <fstream>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+
+namespace XS
+{
+    static double                 CommandLineDuration( const std::string & value );
+    static std::vector< uint8_t > CommandLineHex( const std::string & value );
+    static unsigned long          CommandLineContention( const KeychainTarget & target, size_t threads, size_t contexts, double seconds );
+    
+    class CommandLine::IMPL
+    {
+        public:
+            
+            typedef int ( IMPL::* Command )( void );
+            
+            IMPL( int argc, const char * argv[] );
+            
+            std::string                      _tool;
+            std::string                      _command;
+            std::vector< std::string >       _arguments;
+            std::map< std::string, Command > _commands;
+            
+            int help( void );
+            int compileWordList( void );
+            int trainMarkov( void );
+            int extractTarget( void );
+            int crack( void );
+            int generate( void );
+            int makeTarget( void );
+            int makeCorpus( void );
+            int plan( void );
+            int benchContention( void );
+            int daemon( void );
+            int job( void );
+            
+            bool candidates( const std::string & wordList, size_t caseMax, size_t substMax, const std::function< bool( const char *, size_t ) > & output );
+    };
+    
+    CommandLine::CommandLine( int argc, const char * argv[] ):
+        impl( new IMPL( argc, argv ) )
+    {}
+    
+    CommandLine::~CommandLine( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( CommandLine & o1, CommandLine & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    bool CommandLine::isCommand( void ) const
+    {
+        return this->impl->_commands.count( this->impl->_command ) > 0;
+    }
+    
+    int CommandLine::run( void )
+    {
+        if( this->isCommand() == false )
+        {
+            return this->impl->help();
+        }
+        
+        try
+        {
+            return ( this->impl->*( this->impl->_commands[ this->impl->_command ] ) )();
+        }
+        catch( const std::exception & e )
+        {
+            std::cerr << this->impl->_command << ": " << e.what() << std::endl;
+        }
+        
+        return EXIT_FAILURE;
+    }
+    
+    CommandLine::IMPL::IMPL( int argc, const char * argv[] ):
+        _tool( ( argc > 0 ) ? argv[ 0 ] : "KeychainCracker" ),
+        _commands
+        (
+            {
+                { "help",             &IMPL::help },
+                { "compile-wordlist", &IMPL::compileWordList },
+                { "train-markov",     &IMPL::trainMarkov },
+                { "extract-target",   &IMPL::extractTarget },
+                { "crack",            &IMPL::crack },
+                { "generate",         &IMPL::generate },
+                { "make-target",      &IMPL::makeTarget },
+                { "make-corpus",      &IMPL::makeCorpus },
+                { "plan",             &IMPL::plan },
+                { "bench-contention", &IMPL::benchContention },
+                { "daemon",           &IMPL::daemon },
+                { "job",              &IMPL::job }
+            }
+        )
+    {
+        int i;
+        
+        if( argc > 1 )
+        {
+            this->_command = argv[ 1 ];
+        }
+        
+        for( i = 2; i < argc; i++ )
+        {
+            this->_arguments.push_back( argv[ i ] );
+        }
+    }
+    
+    int CommandLine::IMPL::help( void )
+    {
+        std::cout << "Usage: " << this->_tool << " <command> [options]"                                << std::endl
+                  << std::endl
+                  << "Commands:"                                                                       << std::endl
+                  << std::endl
+                  << "    compile-wordlist [--normalize] [--sort-by-length] <input.txt> <output.kcwl>" << std::endl
+                  << "        Deduplicates a text word list and writes it as an indexed binary file."  << std::endl
+                  << "        --normalize trims whitespace and lowercases ASCII letters."              << std::endl
+                  << "        --sort-by-length groups words of the same length together."              << std::endl
+                  << std::endl
+                  << "    train-markov [--positions <n>] <word list> <output.kcmk>"                    << std::endl
+                  << "        Trains per-position character statistics for Markov mode."               << std::endl
+                  << "        --positions sets the number of trained positions (default: 12)."         << std::endl
+                  << std::endl
+                  << "    extract-target <keychain> <output.kctd>"                                     << std::endl
+                  << "        Writes what is needed to test passwords against a keychain to a small"   << std::endl
+                  << "        descriptor, which can be used instead of the keychain file."             << std::endl
+                  << std::endl
+                  << "    crack [--case <n>] [--subst <n>] [--threads <n>] [--fixed-threads]"          << std::endl
+                  << "          <keychain> <word list>"                                                << std::endl
+                  << "        Tries the passwords of a word list, or of the standard input with -."    << std::endl
+                  << "        --case and --subst add variants of words up to n characters."            << std::endl
+                  << "        --threads sets the maximum number of workers (default: CPU count)."      << std::endl
+                  << std::endl
+                  << "    generate [--case <n>] [--subst <n>] <word list>"                             << std::endl
+                  << "        Writes the candidates of a word list and their variants to the"          << std::endl
+                  << "        standard output, one per line, without trying them."                     << std::endl
+                  << std::endl
+                  << "    make-target [--salt <hex>] [--iv <hex>] [--iterations <n>] <password>"       << std::endl
+                  << "                <output.kctd>"                                                   << std::endl
+                  << "        Writes a target descriptor for a known password, as a test fixture."     << std::endl
+                  << "        The salt (20 bytes) and IV (8 bytes) are random unless specified."       << std::endl
+                  << std::endl
+                  << "    make-corpus [--case <n>] [--subst <n>] [--targets <n>] [--seed <n>]"         << std::endl
+                  << "                [--iterations <n>] <word list> <directory>"                      << std::endl
+                  << "        Writes descriptors whose passwords are the first, 25%, 50% and last"     << std::endl
+                  << "        candidates of a word list, one that is not a candidate, and --targets"   << std::endl
+                  << "        random ones (default: 100), listed with their index in corpus.tsv."      << std::endl
+                  << std::endl
+                  << "    plan --budget <time> [--threads <n>] [--journal <path>] [--dry-run]"         << std::endl
+                  << "         <keychain> <plan file>"                                                 << std::endl
+                  << "        Runs the attacks of a plan file in the order most likely to find the"    << std::endl
+                  << "        password within the budget (e.g. 90m, 8h, 2d) and records them in the"   << std::endl
+                  << "        journal. --dry-run only prints the schedule."                            << std::endl
+                  << std::endl
+                  << "    bench-contention [--threads <n>] [--seconds <time>] [--iterations <n>]"      << std::endl
+                  << "        Compares the throughput of workers sharing one locked verifier with"     << std::endl
+                  << "        workers using a verifier each, for 1 to n threads (default: CPU count)." << std::endl
+                  << std::endl
+                  << "    daemon [--socket <path>] [--threads <n>] [--fixed-threads]"                  << std::endl
+                  << "        Runs cracking jobs on a shared worker pool, controlled over a socket."   << std::endl
+                  << "        --threads sets the maximum number of workers (default: CPU count)."      << std::endl
+                  << "        --fixed-threads disables adaptive tuning of the number of workers."      << std::endl
+                  << std::endl
+                  << "    job [--socket <path>] <request> [arguments...]"                              << std::endl
+                  << "        Sends a request to a running daemon:"                                    << std::endl
+                  << "            submit <keychain> <word list> [priority] [case-max] [subst-max]"     << std::endl
+                  << "            list | status <id> | pause <id> | resume <id> | cancel <id>"         << std::endl
+                  << "            priority <id> <priority> | shutdown"                                 << std::endl
+                  << std::endl;
+        
+        return ( this->_command == "help" ) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    
+    int CommandLine::IMPL::compileWordList( void )
+    {
+        std::vector< std::string >          files;
+        unsigned int                        options;
+        CompiledWordList::CompileStatistics stats;
+        
+        options = CompiledWordList::CompileOptionNone;
+        
+        for( const auto & arg: this->_arguments )
+        {
+            if( arg == "--normalize" )
+            {
+                options |= CompiledWordList::CompileOptionNormalize;
+            }
+            else if( arg == "--sort-by-length" )
+            {
+                options |= CompiledWordList::CompileOptionSortByLength;
+            }
+            else
+            {
+                files.push_back( arg );
+            }
+        }
+        
+        if( files.size() != 2 )
+        {
+            return this->help();
+        }
+        
+        stats = CompiledWordList::compile( files[ 0 ], files[ 1 ], options );
+        
+        std::cout << "Read "     << stats.lines      << " lines, "
+                  << "skipped "  << stats.duplicates << " duplicates, "
+                  << "wrote "    << stats.words      << " words "
+                  << "("         << stats.bytes      << " bytes) to "
+                  << files[ 1 ]
+                  << std::endl;
+        
+        return EXIT_SUCCESS;
+    }
+    
+    int CommandLine::IMPL::trainMarkov( void )
+    {
+        std::vector< std::string >   files;
+        size_t                       positions;
+        size_t                       i;
+        MarkovModel::TrainStatistics stats;
+        
+        positions = 12;
+        
+        for( i = 0; i < this->_arguments.size(); i++ )
+        {
+            if( this->_arguments[ i ] == "--positions" && i + 1 < this->_arguments.size() )
+            {
+                positions = std::stoul( this->_arguments[ ++i ] );
+            }
+            else
+            {
+                files.push_back( this->_arguments[ i ] );
+            }
+        }
+        
+        if( files.size() != 2 )
+        {
+            return this->help();
+        }
+        
+        stats = MarkovModel::train( files[ 0 ], files[ 1 ], positions );
+        
+        std::cout << "Trained "  << stats.positions << " positions "
+                  << "from "     << stats.words     << " words "
+                  << "(skipped " << stats.skipped   << " non-ASCII words) to "
+                  << files[ 1 ]
+                  << std::endl;
+        
+        return EXIT_SUCCESS;
+    }
+    
+    int CommandLine::IMPL::extractTarget( void )
+    {
+        if( this->_arguments.size() != 2 )
+        {
+            return this->help();
+        }
+        
+        {
+            KeychainTarget target( this->_arguments[ 0 ] );
+            
+            target.write( this->_arguments[ 1 ] );
+        }
+        
+        {
+            KeychainTarget target( this->_arguments[ 1 ] );
+            
+            std::cout << "Wrote " << target.blob().size() << " bytes of wrapped key "
+                      << "("      << target.iterations()  << " iterations) to "
+                      << this->_arguments[ 1 ]
+                      << std::endl;
+        }
+        
+        return EXIT_SUCCESS;
+    }
+    
+    int CommandLine::IMPL::crack( void )
+    {
+        std::vector< std::string > files;
+        size_t                     caseMax;
+        size_t                     substMax;
+        size_t                     threads;
+        bool                       adaptive;
+        size_t                     i;
+        std::mutex                 mtx;
+        std::condition_variable    cv;
+        bool                       done;
+        bool                       found;
+        std::string                password;
+        std::string                message;
+        
+        caseMax  = 0;
+        substMax = 0;
+        threads  = std::max( std::thread::hardware_concurrency(), 1U );
+        adaptive = true;
+        done     = false;
+        found    = false;
+        
+        for( i = 0; i < this->_arguments.size(); i++ )
+        {
+            if( this->_arguments[ i ] == "--case" && i + 1 < this->_arguments.size() )
+            {
+                caseMax = std::stoul( this->_arguments[ ++i ] );
+            }
+            else if( this->_arguments[ i ] == "--subst" && i + 1 < this->_arguments.size() )
+            {
+                substMax = std::stoul( this->_arguments[ ++i ] );
+            }
+            else if( this->_arguments[ i ] == "--threads" && i + 1 < this->_arguments.size() )
+            {
+                threads = std::max( std::stoul( this->_arguments[ ++i ] ), 1UL );
+            }
+            else if( this->_arguments[ i ] == "--fixed-threads" )
+            {
+                adaptive = false;
+            }
+            else
+            {
+                files.push_back( this->_arguments[ i ] );
+            }
+        }
+        
+        if( files.size() != 2 )
+        {
+            return this->help();
+        }
+        
+        KeychainCracker cracker( files[ 0 ], files[ 1 ] );
+        
+        cracker.maxThreads( threads );
+        cracker.adaptiveThreads( adaptive );
+        cracker.maxCharsForCaseVariants( caseMax );
+        cracker.maxCharsForCommonSubstitutions( substMax );
+        
+        cracker.crack
+        (
+            [ & ]( bool result, const std::string & value )
+            {
+                std::lock_guard< std::mutex > l( mtx );
+                
+                done     = true;
+                found    = result;
+                password = value;
+                
+                cv.notify_all();
+            }
+        );
+        
+        while( true )
+        {
+            {
+                std::unique_lock< std::mutex > l( mtx );
+                
+                if( cv.wait_for( l, std::chrono::seconds( 1 ), [ & ]{ return done; } ) )
+                {
+                    break;
+                }
+            }
+            
+            message = cracker.message();
+            
+            if( message.length() > 0 )
+            {
+                std::clog << message << std::endl;
+            }
+        }
+        
+        if( found == false )
+        {
+            std::clog << ( ( cracker.error().empty() ) ? "Password not found" : cracker.error() ) << std::endl;
+            
+            return EXIT_FAILURE;
+        }
+        
+        std::cout << password << std::endl;
+        
+        return EXIT_SUCCESS;
+    }
+    
+    int CommandLine::IMPL::generate( void )
+    {
+        std::vector< std::string > files;
+        size_t                     caseMax;
+        size_t                     substMax;
+        size_t                     i;
+        unsigned long              written;
+        std::vector< char >        buffer;
+        
+        caseMax  = 0;
+        substMax = 0;
+        written  = 0;
+        
+        for( i = 0; i < this->_arguments.size(); i++ )
+        {
+            if( this->_arguments[ i ] == "--case" && i + 1 < this->_arguments.size() )
+            {
+                caseMax = std::stoul( this->_arguments[ ++i ] );
+            }
+            else if( this->_arguments[ i ] == "--subst" && i + 1 < this->_arguments.size() )
+            {
+                substMax = std::stoul( this->_arguments[ ++i ] );
+            }
+            else
+            {
+                files.push_back( this->_arguments[ i ] );
+            }
+        }
+        
+        if( files.size() != 1 )
+        {
+            return this->help();
+        }
+        
+        buffer.reserve( 1024 * 1024 );
+        
+        if
+        (
+            this->candidates
+            (
+                files[ 0 ],
+                caseMax,
+                substMax,
+                [ & ]( const char * candidate, size_t length )
+                {
+                    if( buffer.size() + length + 1 > buffer.capacity() )
+                    {
+                        if( fwrite( buffer.data(), 1, buffer.size(), stdout ) != buffer.size() )
+                        {
+                            return false;
+                        }
+                        
+                        buffer.clear();
+                    }
+                    
+                    buffer.insert( buffer.end(), candidate, candidate + length );
+                    buffer.push_back( '\n' );
+                    
+                    written++;
+                    
+                    return true;
+                }
+            )
+            == false
+        )
+        {
+            return EXIT_FAILURE;
+        }
+        
+        if( fwrite( buffer.data(), 1, buffer.size(), stdout ) != buffer.size() || fflush( stdout ) != 0 )
+        {
+            return EXIT_FAILURE;
+        }
+        
+        std::clog << "Wrote " << written << " candidates" << std::endl;
+        
+        return EXIT_SUCCESS;
+    }
+    
+    int CommandLine::IMPL::makeTarget( void )
+    {
+        std::vector< std::string > files;
+        std::vector< uint8_t >     salt;
+        std::vector< uint8_t >     iv;
+        uint32_t                   iterations;
+        size_t                     i;
+        std::random_device         random;
+        
+        iterations = 1000;
+        
+        for( i = 0; i < this->_arguments.size(); i++ )
+        {
+            if( this->_arguments[ i ] == "--salt" && i + 1 < this->_arguments.size() )
+            {
+                salt = CommandLineHex( this->_arguments[ ++i ] );
+            }
+            else if( this->_arguments[ i ] == "--iv" && i + 1 < this->_arguments.size() )
+            {
+                iv = CommandLineHex( this->_arguments[ ++i ] );
+            }
+            else if( this->_arguments[ i ] == "--iterations" && i + 1 < this->_arguments.size() )
+            {
+                iterations = static_cast< uint32_t >( std::stoul( this->_arguments[ ++i ] ) );
+            }
+            else
+            {
+                files.push_back( this->_arguments[ i ] );
+            }
+        }
+        
+        if( files.size() != 2 )
+        {
+            return this->help();
+        }
+        
+        if( salt.empty() )
+        {
+            salt.resize( KeychainTarget::SaltLength );
+            
+            for( auto & b: salt )
+            {
+                b = static_cast< uint8_t >( random() );
+            }
+        }
+        
+        if( iv.empty() )
+        {
+            iv.resize( KeychainTarget::IVLength );
+            
+            for( auto & b: iv )
+            {
+                b = static_cast< uint8_t >( random() );
+            }
+        }
+        
+        KeychainTarget( files[ 0 ], salt, iv, iterations ).write( files[ 1 ] );
+        
+        std::cout << "Wrote target for a " << files[ 0 ].length() << " bytes password "
+                  << "(" << iterations << " iterations) to "
+                  << files[ 1 ]
+                  << std::endl;
+        
+        return EXIT_SUCCESS;
+    }
+    
+    int CommandLine::IMPL::makeCorpus( void )
+    {
+        std::vector< std::string >                        files;
+        size_t                                            caseMax;
+        size_t                                            substMax;
+        size_t                                            targets;
+        uint32_t                                          iterations;
+        size_t                                            i;
+        uint64_t                                          count;
+        std::mt19937_64                                   random;
+        std::map< uint64_t, std::string >                 passwords;
+        std::vector< std::pair< std::string, uint64_t > > corpus;
+        std::string                                       miss;
+        std::ofstream                                     manifest;
+        
+        caseMax    = 0;
+        substMax   = 0;
+        targets    = 100;
+        iterations = 1000;
+        count      = 0;
+        
+        random.seed( 1 );
+        
+        for( i = 0; i < this->_arguments.size(); i++ )
+        {
+            if( this->_arguments[ i ] == "--case" && i + 1 < this->_arguments.size() )
+            {
+                caseMax = std::stoul( this->_arguments[ ++i ] );
+            }
+            else if( this->_arguments[ i ] == "--subst" && i + 1 < this->_arguments.size() )
+            {
+                substMax = std::stoul( this->_arguments[ ++i ] );
+            }
+            else if( this->_arguments[ i ] == "--targets" && i + 1 < this->_arguments.size() )
+            {
+                targets = std::stoul( this->_arguments[ ++i ] );
+            }
+            else if( this->_arguments[ i ] == "--iterations" && i + 1 < this->_arguments.size() )
+            {
+                iterations = static_cast< uint32_t >( std::stoul( this->_arguments[ ++i ] ) );
+            }
+            else if( this->_arguments[ i ] == "--seed" && i + 1 < this->_arguments.size() )
+            {
+                random.seed( std::stoull( this->_arguments[ ++i ] ) );
+            }
+            else
+            {
+                files.push_back( this->_arguments[ i ] );
+            }
+        }
+        
+        if( files.size() != 2 )
+        {
+            return this->help();
+        }
+        
+        this->candidates
+        (
+            files[ 0 ],
+            caseMax,
+            substMax,
+            [ & ]( const char *, size_t )
+            {
+                count++;
+                
+                return true;
+            }
+        );
+        
+        if( count == 0 )
+        {
+            throw std::runtime_error( "No candidates in " + files[ 0 ] );
+        }
+        
+        for( const auto & index: { static_cast< uint64_t >( 0 ), count / 4, count / 2, count - 1 } )
+        {
+            if( corpus.empty() || corpus.back().second != index )
+            {
+                corpus.push_back( std::make_pair( "hit-" + std::to_string( index ), index ) );
+            }
+        }
+        
+        for( i = 0; i < targets; i++ )
+        {
+            corpus.push_back( std::make_pair( "target-" + std::to_string( i + 1 ), random() % count ) );
+        }
+        
+        for( const auto & entry: corpus )
+        {
+            passwords[ entry.second ] = "";
+        }
+        
+        while( miss.length() < 24 )
+        {
+            miss += "0123456789abcdef"[ random() % 16 ];
+        }
+        
+        count = 0;
+        
+        this->candidates
+        (
+            files[ 0 ],
+            caseMax,
+            substMax,
+            [ & ]( const char * candidate, size_t length )
+            {
+                if( passwords.count( count ) > 0 )
+                {
+                    passwords[ count ].assign( candidate, length );
+                }
+                
+                if( miss.length() == length && memcmp( miss.data(), candidate, length ) == 0 )
+                {
+                    throw std::runtime_error( "Generated miss password is a candidate" );
+                }
+                
+                count++;
+                
+                return true;
+            }
+        );
+        
+        mkdir( files[ 1 ].c_str(), 0755 );
+        manifest.open( files[ 1 ] + "/corpus.tsv" );
+        
+        if( manifest.good() == false )
+        {
+            throw std::runtime_error( "Cannot create " + files[ 1 ] + "/corpus.tsv" );
+        }
+        
+        corpus.push_back( std::make_pair( "miss", count ) );
+        
+        for( const auto & entry: corpus )
+        {
+            std::vector< uint8_t > salt( KeychainTarget::SaltLength );
+            std::vector< uint8_t > iv( KeychainTarget::IVLength );
+            
+            for( auto & b: salt )
+            {
+                b = static_cast< uint8_t >( random() );
+            }
+            
+            for( auto & b: iv )
+            {
+                b = static_cast< uint8_t >( random() );
+            }
+            
+            KeychainTarget( ( entry.second < count ) ? passwords[ entry.second ] : miss, salt, iv, iterations ).write( files[ 1 ] + "/" + entry.first + ".kctd" );
+            
+            manifest << entry.first << ".kctd\t"
+                     << ( ( entry.second < count ) ? std::to_string( entry.second ) : "-" ) << "\t"
+                     << ( ( entry.second < count ) ? passwords[ entry.second ] : miss )
+                     << std::endl;
+        }
+        
+        std::cout << "Wrote " << corpus.size() << " targets for " << count << " candidates to " << files[ 1 ] << std::endl;
+        
+        return EXIT_SUCCESS;
+    }
+    
+    int CommandLine::IMPL::plan( void )
+    {
+        std::vector< std::string >           files;
+        std::string                          journalPath;
+        double                               budget;
+        size_t                               threads;
+        bool                                 dryRun;
+        size_t                               i;
+        std::vector< AttackPlanner::Attack > schedule;
+        double                               elapsed;
+        std::string                          password;
+        
+        journalPath = RunJournal::defaultPath();
+        budget      = 0;
+        threads     = std::max( std::thread::hardware_concurrency(), 1U );
+        dryRun      = false;
+        elapsed     = 0;
+        
+        for( i = 0; i < this->_arguments.size(); i++ )
+        {
+            if( this->_arguments[ i ] == "--budget" && i + 1 < this->_arguments.size() )
+            {
+                budget = CommandLineDuration( this->_arguments[ ++i ] );
+            }
+            else if( this->_arguments[ i ] == "--threads" && i + 1 < this->_arguments.size() )
+            {
+                threads = std::max( std::stoul( this->_arguments[ ++i ] ), 1UL );
+            }
+            else if( this->_arguments[ i ] == "--journal" && i + 1 < this->_arguments.size() )
+            {
+                journalPath = this->_arguments[ ++i ];
+            }
+            else if( this->_arguments[ i ] == "--dry-run" )
+            {
+                dryRun = true;
+            }
+            else
+            {
+                files.push_back( this->_arguments[ i ] );
+            }
+        }
+        
+        if( files.size() != 2 || budget <= 0 )
+        {
+            return this->help();
+        }
+        
+        RunJournal    journal( journalPath );
+        AttackPlanner planner( files[ 0 ], files[ 1 ], journal );
+        
+        planner.maxThreads( threads );
+        planner.logger
+        (
+            []( const std::string & message )
+            {
+                std::clog << "plan: " << message << std::endl;
+            }
+        );
+        
+        schedule = planner.schedule();
+        
+        std::clog << std::left
+                  << std::setw( 20 ) << "Attack"
+                  << std::setw( 16 ) << "Candidates"
+                  << std::setw( 12 ) << "P(hit)"
+                  << std::setw( 14 ) << "Candidates/s"
+                  << "Start"
+                  << std::endl;
+        
+        for( const auto & attack: schedule )
+        {
+            std::clog << std::setw( 20 ) << attack.name
+                      << std::setw( 16 ) << attack.keyspace
+                      << std::setw( 12 ) << std::setprecision( 3 ) << attack.probability
+                      << std::setw( 14 ) << ( ( attack.rate > 0 ) ? std::to_string( static_cast< unsigned long >( attack.rate ) ) : "unknown" )
+                      << ( ( attack.rate <= 0 ) ? "" : ( elapsed < budget ) ? std::to_string( static_cast< unsigned long >( elapsed ) ) + " s" : "over budget" )
+                      << std::endl;
+            
+            elapsed += attack.seconds;
+        }
+        
+        if( schedule.size() > 0 && schedule.front().rate > 0 )
+        {
+            std::clog << "Estimated chance of a hit within the budget: " << planner.chance( schedule, budget ) << std::endl;
+        }
+        
+        if( dryRun )
+        {
+            return EXIT_SUCCESS;
+        }
+        
+        if( planner.run( budget, password ) == false )
+        {
+            std::clog << "Password not found" << std::endl;
+            
+            return EXIT_FAILURE;
+        }
+        
+        std::cout << password << std::endl;
+        
+        return EXIT_SUCCESS;
+    }
+    
+    int CommandLine::IMPL::benchContention( void )
+    {
+        size_t        threads;
+        double        seconds;
+        uint32_t      iterations;
+        size_t        i;
+        size_t        n;
+        unsigned long shared;
+        unsigned long separate;
+        
+        threads    = std::max( std::thread::hardware_concurrency(), 1U );
+        seconds    = 2;
+        iterations = 1000;
+        
+        for( i = 0; i < this->_arguments.size(); i++ )
+        {
+            if( this->_arguments[ i ] == "--threads" && i + 1 < this->_arguments.size() )
+            {
+                threads = std::max( std::stoul( this->_arguments[ ++i ] ), 1UL );
+            }
+            else if( this->_arguments[ i ] == "--seconds" && i + 1 < this->_arguments.size() )
+            {
+                seconds = CommandLineDuration( this->_arguments[ ++i ] );
+            }
+            else if( this->_arguments[ i ] == "--iterations" && i + 1 < this->_arguments.size() )
+            {
+                iterations = static_cast< uint32_t >( std::stoul( this->_arguments[ ++i ] ) );
+            }
+            else
+            {
+                return this->help();
+            }
+        }
+        
+        if( seconds <= 0 )
+        {
+            return this->help();
+        }
+        
+        KeychainTarget target( "KeychainCracker", std::vector< uint8_t >( KeychainTarget::SaltLength ), std::vector< uint8_t >( KeychainTarget::IVLength ), iterations );
+        
+        std::cout << std::left
+                  << std::setw( 10 ) << "Threads"
+                  << std::setw( 16 ) << "Shared/s"
+                  << std::setw( 16 ) << "Per-worker/s"
+                  << "Speedup"
+                  << std::endl;
+        
+        for( n = 1; n <= threads; n = ( n < threads && n * 2 > threads ) ? threads : n * 2 )
+        {
+            shared   = CommandLineContention( target, n, 1, seconds );
+            separate = CommandLineContention( target, n, n, seconds );
+            
+            std::cout << std::setw( 10 ) << n
+                      << std::setw( 16 ) << static_cast< unsigned long >( static_cast< double >( shared )   / seconds )
+                      << std::setw( 16 ) << static_cast< unsigned long >( static_cast< double >( separate ) / seconds )
+                      << std::setprecision( 3 ) << ( ( shared > 0 ) ? static_cast< double >( separate ) / static_cast< double >( shared ) : 0.0 )
+                      << std::endl;
+        }
+        
+        return EXIT_SUCCESS;
+    }
+    
+    bool CommandLine::IMPL::candidates( const std::string & wordList, size_t caseMax, size_t substMax, const std::function< bool( const char *, size_t ) > & output )
+    {
+        std::unique_ptr< CompiledWordList > list;
+        std::unique_ptr< CandidateSource >  source;
+        WordListStream                    * stream;
+        CandidateBatch                      batch;
+        std::string                         variant;
+        size_t                              i;
+        uint64_t                            j;
+        uint64_t                            n;
+        
+        stream = nullptr;
+        
+        if( CompiledWordList::isCompiledWordList( wordList ) )
+        {
+            list.reset( new CompiledWordList( wordList ) );
+            source.reset( new CompiledWordListSource( *( list ) ) );
+        }
+        else
+        {
+            stream = new WordListStream( wordList );
+            
+            source.reset( stream );
+        }
+        
+        source->restart();
+        
+        while( source->next( batch, 4096 ) )
+        {
+            for( i = 0; i < batch.count(); i++ )
+            {
+                if( caseMax == 0 && substMax == 0 )
+                {
+                    if( output( batch.candidate( i ), batch.length( i ) ) == false )
+                    {
+                        return false;
+                    }
+                    
+                    continue;
+                }
+                
+                n = PasswordVariants::count( batch.candidate( i ), batch.length( i ), caseMax, substMax );
+                
+                for( j = 0; j < n; j++ )
+                {
+                    PasswordVariants::variant( batch.candidate( i ), batch.length( i ), j, caseMax, substMax, variant );
+                    
+                    if( output( variant.data(), variant.size() ) == false )
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        
+        if( stream != nullptr && stream->error().length() > 0 )
+        {
+            throw std::runtime_error( stream->error() );
+        }
+        
+        return true;
+    }
+    
+    int CommandLine::IMPL::daemon( void )
+    {
+        std::string socket;
+        size_t      threads;
+        bool        adaptive;
+        size_t      i;
+        
+        socket   = DaemonServer::defaultSocketPath();
+        threads  = std::max( std::thread::hardware_concurrency(), 1U );
+        adaptive = true;
+        
+        for( i = 0; i < this->_arguments.size(); i++ )
+        {
+            if( this->_arguments[ i ] == "--socket" && i + 1 < this->_arguments.size() )
+            {
+                socket = this->_arguments[ ++i ];
+            }
+            else if( this->_arguments[ i ] == "--threads" && i + 1 < this->_arguments.size() )
+            {
+                threads = std::max( std::stoul( this->_arguments[ ++i ] ), 1UL );
+            }
+            else if( this->_arguments[ i ] == "--fixed-threads" )
+            {
+                adaptive = false;
+            }
+            else
+            {
+                return this->help();
+            }
+        }
+        
+        DaemonServer::handleSignals();
+        
+        {
+            JobScheduler scheduler( threads, adaptive );
+            DaemonServer server( socket, scheduler );
+            
+            scheduler.logger
+            (
+                []( const std::string & message )
+                {
+                    std::clog << "daemon: " << message << std::endl;
+                }
+            );
+            
+            std::clog << "daemon: listening on " << socket << " with up to " << threads << " workers" << std::endl;
+            
+            server.run();
+        }
+        
+        std::clog << "daemon: stopped" << std::endl;
+        
+        return EXIT_SUCCESS;
+    }
+    
+    int CommandLine::IMPL::job( void )
+    {
+        std::string                socket;
+        std::vector< std::string > fields;
+        std::vector< std::string > response;
+        size_t                     i;
+        bool                       ok;
+        
+        socket = DaemonServer::defaultSocketPath();
+        
+        for( i = 0; i < this->_arguments.size(); i++ )
+        {
+            if( fields.empty() && this->_arguments[ i ] == "--socket" && i + 1 < this->_arguments.size() )
+            {
+                socket = this->_arguments[ ++i ];
+            }
+            else
+            {
+                fields.push_back( this->_arguments[ i ] );
+            }
+        }
+        
+        if( fields.empty() )
+        {
+            return this->help();
+        }
+        
+        for( i = 1; fields[ 0 ] == "submit" && i < std::min( fields.size(), static_cast< size_t >( 3 ) ); i++ )
+        {
+            char * path;
+            
+            path = realpath( fields[ i ].c_str(), nullptr );
+            
+            if( path != nullptr )
+            {
+                fields[ i ] = path;
+                
+                free( path );
+            }
+        }
+        
+        ok = DaemonServer::request( socket, fields, response );
+        
+        for( const auto & line: response )
+        {
+            ( ( ok ) ? std::cout : std::cerr ) << line << std::endl;
+        }
+        
+        return ( ok ) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    
+    static double CommandLineDuration( const std::string & value )
+    {
+        size_t end;
+        double duration;
+        
+        duration = std::stod( value, &end );
+        
+        if( end == value.length() || value.substr( end ) == "s" )
+        {
+            return duration;
+        }
+        else if( value.substr( end ) == "m" )
+        {
+            return duration * 60;
+        }
+        else if( value.substr( end ) == "h" )
+        {
+            return duration * 3600;
+        }
+        else if( value.substr( end ) == "d" )
+        {
+            return duration * 86400;
+        }
+        
+        throw std::invalid_argument( "Invalid duration: " + value );
+    }
+    
+    static std::vector< uint8_t > CommandLineHex( const std::string & value )
+    {
+        std::vector< uint8_t > bytes;
+        size_t                 i;
+        
+        if( value.length() % 2 != 0 || value.find_first_not_of( "0123456789abcdefABCDEF" ) != std::string::npos )
+        {
+            throw std::invalid_argument( "Invalid hexadecimal value: " + value );
+        }
+        
+        for( i = 0; i < value.length(); i += 2 )
+        {
+            bytes.push_back( static_cast< uint8_t >( std::stoul( value.substr( i, 2 ), nullptr, 16 ) ) );
+        }
+        
+        return bytes;
+    }
+    
+    static unsigned long CommandLineContention( const KeychainTarget & target, size_t threads, size_t contexts, double seconds )
+    {
+        std::vector< std::mutex >                          locks( contexts );
+        std::vector< std::unique_ptr< KeychainVerifier > > verifiers;
+        std::vector< std::thread >                         workers;
+        std::atomic< unsigned long >                       count;
+        std::atomic< bool >                                stop;
+        size_t                                             i;
+        
+        count = 0;
+        stop  = false;
+        
+        for( i = 0; i < contexts; i++ )
+        {
+            verifiers.push_back( std::unique_ptr< KeychainVerifier >( new KeychainVerifier( target ) ) );
+        }
+        
+        for( i = 0; i < threads; i++ )
+        {
+            workers.push_back
+            (
+                std::thread
+                (
+                    [ &, i ]
+                    {
+                        while( stop == false )
+                        {
+                            std::lock_guard< std::mutex > l( locks[ i % contexts ] );
+                            
+                            verifiers[ i % contexts ]->verify( "KeychainCracker", 15 );
+                            
+                            count++;
+                        }
+                    }
+                )
+            );
+        }
+        
+        std::this_thread::sleep_for( std::chrono::duration< double >( seconds ) );
+        
+        stop = true;
+        
+        for( auto & t: workers )
+        {
+            t.join();
+        }
+        
+        return count;
+    }
+}
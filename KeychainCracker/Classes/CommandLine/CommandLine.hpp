@@ -0,0 +1,62 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      CommandLine.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_COMMAND_LINE_HPP
+#define XS_COMMAND_LINE_HPP
+
+#include <string>
+#include <vector>
+
+namespace XS
+{
+    class CommandLine
+    {
+        public:
+            
+            CommandLine( int argc, const char * argv[] );
+            ~CommandLine( void );
+            
+            CommandLine( const CommandLine & o )      = delete;
+            CommandLine( CommandLine && o )           = delete;
+            CommandLine & operator =( CommandLine o ) = delete;
+            
+            friend void swap( CommandLine & o1, CommandLine & o2 );
+            
+            bool isCommand( void ) const;
+            int  run( void );
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_COMMAND_LINE_HPP */
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      CandidateBatch.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_CANDIDATE_BATCH_HPP
+#define XS_CANDIDATE_BATCH_HPP
+
+#include <vector>
+#include <cstddef>
+
+namespace XS
+{
+    class CandidateBatch
+    {
+        public:
+            
+            void clear( void )
+            {
+                this->_data.clear();
+                this->_candidates.clear();
+            }
+            
+            void add( const char * candidate, size_t length )
+            {
+                this->_candidates.push_back( { nullptr, this->_data.size(), length } );
+                this->_data.insert( this->_data.end(), candidate, candidate + length );
+            }
+            
+            void addReference( const char * candidate, size_t length )
+            {
+                this->_candidates.push_back( { candidate, 0, length } );
+            }
+            
+            size_t count( void ) const
+            {
+                return this->_candidates.size();
+            }
+            
+            const char * candidate( size_t index ) const
+            {
+                const Candidate & c = this->_candidates[ index ];
+                
+                return ( c.reference != nullptr ) ? c.reference : this->_data.data() + c.offset;
+            }
+            
+            size_t length( size_t index ) const
+            {
+                return this->_candidates[ index ].length;
+            }
+            
+        private:
+            
+            struct Candidate
+            {
+                const char * reference;
+                size_t       offset;
+                size_t       length;
+            };
+            
+            std::vector< char >      _data;
+            std::vector< Candidate > _candidates;
+    };
+}
+
+#endif /* XS_CANDIDATE_BATCH_HPP */
@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      CandidateSource.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_CANDIDATE_SOURCE_HPP
+#define XS_CANDIDATE_SOURCE_HPP
+
+#include "CandidateBatch.hpp"
+
+namespace XS
+{
+    class TraceRecorder;
+    
+    class CandidateSource
+    {
+        public:
+            
+            virtual ~CandidateSource( void ) = default;
+            
+            virtual void   restart( void )                             = 0;
+            virtual bool   next( CandidateBatch & batch, size_t max )  = 0;
+            virtual size_t count( void )                         const = 0;
+            virtual double progress( void )                      const = 0;
+            
+            virtual void tracer( TraceRecorder * recorder )
+            {
+                ( void )recorder;
+            }
+    };
+}
+
+#endif /* XS_CANDIDATE_SOURCE_HPP */
@@ -0,0 +1,333 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        ConcurrencyController.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "ConcurrencyController.hpp"
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+
+namespace XS
+{
+    static const size_t ConcurrencyControllerWindow    = 3;
+    static const size_t ConcurrencyControllerWarmUp    = 1;
+    static const double ConcurrencyControllerGain      = 1.05;
+    static const double ConcurrencyControllerDrop      = 0.85;
+    static const size_t ConcurrencyControllerMaxDrops  = 2;
+    
+    class ConcurrencyController::IMPL
+    {
+        public:
+            
+            IMPL( size_t maxWorkers, bool adaptive );
+            
+            void apply( size_t active, const std::string & reason );
+            void explore( double rate );
+            void monitor( double rate );
+            void log( const std::string & message );
+            
+            size_t                       _maxWorkers;
+            bool                         _adaptive;
+            std::atomic< size_t >        _active;
+            std::atomic< bool >          _settled;
+            std::mutex                   _mtx;
+            std::condition_variable      _cv;
+            unsigned long                _lastProcessed;
+            size_t                       _warmUp;
+            std::vector< unsigned long > _samples;
+            size_t                       _step;
+            long                         _direction;
+            double                       _bestRate;
+            size_t                       _bestActive;
+            double                       _baseline;
+            size_t                       _drops;
+            
+            std::function< void( const std::string & ) > _log;
+    };
+    
+    ConcurrencyController::ConcurrencyController( size_t maxWorkers, bool adaptive ):
+        impl( new IMPL( maxWorkers, adaptive ) )
+    {}
+    
+    ConcurrencyController::~ConcurrencyController( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( ConcurrencyController & o1, ConcurrencyController & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    size_t ConcurrencyController::maxWorkers( void ) const
+    {
+        return this->impl->_maxWorkers;
+    }
+    
+    size_t ConcurrencyController::activeWorkers( void ) const
+    {
+        return this->impl->_active;
+    }
+    
+    bool ConcurrencyController::isSettled( void ) const
+    {
+        return this->impl->_settled;
+    }
+    
+    void ConcurrencyController::waitUntilActive( size_t worker, unsigned int milliseconds )
+    {
+        std::unique_lock< std::mutex > l( this->impl->_mtx );
+        
+        this->impl->_cv.wait_for
+        (
+            l,
+            std::chrono::milliseconds( milliseconds ),
+            [ this, worker ]
+            {
+                return worker < this->impl->_active;
+            }
+        );
+    }
+    
+    void ConcurrencyController::update( unsigned long processed )
+    {
+        unsigned long delta;
+        double        rate;
+        
+        if( this->impl->_adaptive == false )
+        {
+            return;
+        }
+        
+        delta                      = ( processed > this->impl->_lastProcessed ) ? processed - this->impl->_lastProcessed : 0;
+        this->impl->_lastProcessed = processed;
+        
+        if( this->impl->_warmUp > 0 )
+        {
+            this->impl->_warmUp--;
+            
+            return;
+        }
+        
+        this->impl->_samples.push_back( delta );
+        
+        if( this->impl->_samples.size() < ConcurrencyControllerWindow )
+        {
+            return;
+        }
+        
+        rate = 0;
+        
+        for( auto sample: this->impl->_samples )
+        {
+            rate += static_cast< double >( sample );
+        }
+        
+        rate /= static_cast< double >( this->impl->_samples.size() );
+        
+        this->impl->_samples.clear();
+        
+        if( this->impl->_settled )
+        {
+            this->impl->monitor( rate );
+        }
+        else
+        {
+            this->impl->explore( rate );
+        }
+    }
+    
+    void ConcurrencyController::logger( const std::function< void( const std::string & ) > & log )
+    {
+        this->impl->_log = log;
+    }
+    
+    ConcurrencyController::IMPL::IMPL( size_t maxWorkers, bool adaptive ):
+        _maxWorkers(    std::max( maxWorkers, static_cast< size_t >( 1 ) ) ),
+        _adaptive(      adaptive && maxWorkers > 1 ),
+        _active(        0 ),
+        _settled(       false ),
+        _lastProcessed( 0 ),
+        _warmUp(        ConcurrencyControllerWarmUp ),
+        _step(          1 ),
+        _direction(     1 ),
+        _bestRate(      0 ),
+        _bestActive(    0 ),
+        _baseline(      0 ),
+        _drops(         0 )
+    {
+        size_t cores;
+        
+        if( this->_adaptive == false )
+        {
+            this->_active  = this->_maxWorkers;
+            this->_settled = true;
+            
+            return;
+        }
+        
+        cores             = std::max( static_cast< size_t >( std::thread::hardware_concurrency() ), static_cast< size_t >( 1 ) );
+        this->_active     = std::min( cores, this->_maxWorkers );
+        this->_bestActive = this->_active;
+        this->_step       = std::max( this->_active / 2, static_cast< size_t >( 1 ) );
+    }
+    
+    void ConcurrencyController::IMPL::apply( size_t active, const std::string & reason )
+    {
+        active = std::min( std::max( active, static_cast< size_t >( 1 ) ), this->_maxWorkers );
+        
+        if( active != this->_active )
+        {
+            std::ostringstream os;
+            
+            os << reason << ": " << this->_active << " -> " << active << " workers";
+            
+            this->log( os.str() );
+        }
+        
+        {
+            std::lock_guard< std::mutex > l( this->_mtx );
+            
+            this->_active = active;
+        }
+        
+        this->_cv.notify_all();
+        
+        this->_warmUp = ConcurrencyControllerWarmUp;
+    }
+    
+    void ConcurrencyController::IMPL::explore( double rate )
+    {
+        size_t next;
+        
+        if( rate > this->_bestRate * ConcurrencyControllerGain || this->_bestRate == 0 )
+        {
+            this->_bestRate   = rate;
+            this->_bestActive = this->_active;
+        }
+        else
+        {
+            if( this->_step <= 1 )
+            {
+                std::ostringstream os;
+                
+                this->_settled  = true;
+                this->_baseline = this->_bestRate;
+                this->_drops    = 0;
+                
+                os << "settled at " << this->_bestActive << " workers (~" << static_cast< unsigned long >( this->_bestRate ) << " / sec)";
+                
+                this->log( os.str() );
+                this->apply( this->_bestActive, "settling" );
+                
+                return;
+            }
+            
+            this->_step      /= 2;
+            this->_direction  = -this->_direction;
+        }
+        
+        if( this->_direction > 0 )
+        {
+            next = std::min( this->_bestActive + this->_step, this->_maxWorkers );
+        }
+        else
+        {
+            next = ( this->_bestActive > this->_step ) ? this->_bestActive - this->_step : 1;
+        }
+        
+        if( next == this->_bestActive )
+        {
+            this->_direction = -this->_direction;
+            this->_step      = std::max( this->_step / 2, static_cast< size_t >( 1 ) );
+            next             = ( this->_direction > 0 ) ? std::min( this->_bestActive + this->_step, this->_maxWorkers ) : ( ( this->_bestActive > this->_step ) ? this->_bestActive - this->_step : 1 );
+        }
+        
+        if( next == this->_bestActive )
+        {
+            this->_settled  = true;
+            this->_baseline = this->_bestRate;
+            
+            this->log( "settled at " + std::to_string( this->_bestActive ) + " workers (no other setting to try)" );
+            
+            return;
+        }
+        
+        this->apply( next, "probing (best ~" + std::to_string( static_cast< unsigned long >( this->_bestRate ) ) + " / sec)" );
+    }
+    
+    void ConcurrencyController::IMPL::monitor( double rate )
+    {
+        if( rate >= this->_baseline * ConcurrencyControllerDrop )
+        {
+            this->_drops    = 0;
+            this->_baseline = this->_baseline * 0.9 + rate * 0.1;
+            
+            return;
+        }
+        
+        if( ++( this->_drops ) < ConcurrencyControllerMaxDrops )
+        {
+            return;
+        }
+        
+        this->log
+        (
+            "throughput dropped from ~"
+          + std::to_string( static_cast< unsigned long >( this->_baseline ) )
+          + " to ~"
+          + std::to_string( static_cast< unsigned long >( rate ) )
+          + " / sec, backing off"
+        );
+        
+        this->_settled    = false;
+        this->_drops      = 0;
+        this->_bestRate   = rate;
+        this->_bestActive = this->_active;
+        this->_direction  = -1;
+        this->_step       = std::max( this->_active / 4, static_cast< size_t >( 1 ) );
+        
+        this->apply( ( this->_active > this->_step ) ? this->_active - this->_step : 1, "backing off" );
+    }
+    
+    void ConcurrencyController::IMPL::log( const std::string & message )
+    {
+        if( this->_log != nullptr )
+        {
+            this->_log( message );
+        }
+    }
+}
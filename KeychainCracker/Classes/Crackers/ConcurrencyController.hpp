@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      ConcurrencyController.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_CONCURRENCY_CONTROLLER_HPP
+#define XS_CONCURRENCY_CONTROLLER_HPP
+
+#include <string>
+#include <functional>
+#include <cstddef>
+
+namespace XS
+{
+    /*!
+     * Tunes the number of active workers while a run is in progress.
+     * 
+     * Throughput is sampled about once per second. The controller climbs
+     * towards the worker count with the best throughput, halving its step
+     * every time a move does not pay off, then settles. Once settled, a
+     * sustained drop in throughput (thermal throttling, other load on the
+     * machine) makes it back off and search again.
+     */
+    class ConcurrencyController
+    {
+        public:
+            
+            ConcurrencyController( size_t maxWorkers, bool adaptive );
+            ~ConcurrencyController( void );
+            
+            ConcurrencyController( const ConcurrencyController & o )      = delete;
+            ConcurrencyController( ConcurrencyController && o )           = delete;
+            ConcurrencyController & operator =( ConcurrencyController o ) = delete;
+            
+            friend void swap( ConcurrencyController & o1, ConcurrencyController & o2 );
+            
+            size_t maxWorkers( void )    const;
+            size_t activeWorkers( void ) const;
+            bool   isSettled( void )     const;
+            
+            void waitUntilActive( size_t worker, unsigned int milliseconds );
+            void update( unsigned long processed );
+            void logger( const std::function< void( const std::string & ) > & log );
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_CONCURRENCY_CONTROLLER_HPP */
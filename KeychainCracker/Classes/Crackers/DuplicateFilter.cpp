@@ -0,0 +1,387 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        DuplicateFilter.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "DuplicateFilter.hpp"
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstring>
+
+namespace XS
+{
+    static const size_t   DuplicateFilterShardBits       = 6;
+    static const size_t   DuplicateFilterShards          = 1 << DuplicateFilterShardBits;
+    static const size_t   DuplicateFilterInitialCapacity = 256;
+    static const size_t   DuplicateFilterBlockWords      = 8;
+    static const size_t   DuplicateFilterHashes          = 7;
+    static const size_t   DuplicateFilterBitsPerItem     = 16;
+    static const uint64_t DuplicateFilterMultiplier      = 0x9E3779B97F4A7C15ULL;
+    
+    static uint64_t DuplicateFilterMix( uint64_t h );
+    static uint64_t DuplicateFilterHash( const char * candidate, size_t length );
+    
+    class DuplicateFilter::IMPL
+    {
+        public:
+            
+            struct Shard
+            {
+                std::mutex              mtx;
+                std::vector< uint64_t > table;
+                size_t                  used;
+            };
+            
+            enum ShardResult
+            {
+                ShardResultInserted,
+                ShardResultDuplicate,
+                ShardResultFull
+            };
+            
+            IMPL( size_t maxBytes );
+            
+            ShardResult shardInsert( Shard & shard, uint64_t fingerprint );
+            bool        bloomInsert( uint64_t fingerprint );
+            void        convert( void );
+            
+            static bool tableInsert( std::vector< uint64_t > & table, uint64_t fingerprint );
+            
+            size_t                                 _maxBytes;
+            std::unique_ptr< Shard[] >             _shards;
+            std::atomic< size_t >                  _tableBytes;
+            std::vector< std::atomic< uint64_t > > _bloom;
+            size_t                                 _bloomBlocks;
+            std::atomic< bool >                    _approximate;
+            std::atomic< uint64_t >                _bloomItems;
+            std::atomic< uint64_t >                _duplicates;
+            std::atomic< uint64_t >                _approximateDuplicates;
+            std::atomic< uint64_t >                _unchecked;
+            std::mutex                             _convertMtx;
+    };
+    
+    DuplicateFilter::DuplicateFilter( size_t maxBytes ):
+        impl( new IMPL( maxBytes ) )
+    {}
+    
+    DuplicateFilter::~DuplicateFilter( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( DuplicateFilter & o1, DuplicateFilter & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    bool DuplicateFilter::insert( const char * candidate, size_t length )
+    {
+        uint64_t          fingerprint;
+        IMPL::ShardResult result;
+        
+        fingerprint = DuplicateFilterHash( candidate, length );
+        
+        if( this->impl->_approximate.load( std::memory_order_acquire ) == false )
+        {
+            IMPL::Shard & shard = this->impl->_shards[ fingerprint >> ( 64 - DuplicateFilterShardBits ) ];
+            
+            {
+                std::lock_guard< std::mutex > l( shard.mtx );
+                
+                result = ( this->impl->_approximate ) ? IMPL::ShardResultFull : this->impl->shardInsert( shard, fingerprint );
+            }
+            
+            if( result == IMPL::ShardResultInserted )
+            {
+                return true;
+            }
+            
+            if( result == IMPL::ShardResultDuplicate )
+            {
+                this->impl->_duplicates++;
+                
+                return false;
+            }
+            
+            this->impl->convert();
+        }
+        
+        if( this->impl->bloomInsert( fingerprint ) )
+        {
+            return true;
+        }
+        
+        this->impl->_duplicates++;
+        this->impl->_approximateDuplicates++;
+        
+        return false;
+    }
+    
+    uint64_t DuplicateFilter::duplicates( void ) const
+    {
+        return this->impl->_duplicates;
+    }
+    
+    uint64_t DuplicateFilter::approximateDuplicates( void ) const
+    {
+        return this->impl->_approximateDuplicates;
+    }
+    
+    uint64_t DuplicateFilter::unchecked( void ) const
+    {
+        return this->impl->_unchecked;
+    }
+    
+    bool DuplicateFilter::isApproximate( void ) const
+    {
+        return this->impl->_approximate;
+    }
+    
+    size_t DuplicateFilter::memoryUsage( void ) const
+    {
+        if( this->impl->_approximate )
+        {
+            return this->impl->_bloom.size() * sizeof( uint64_t );
+        }
+        
+        return this->impl->_tableBytes;
+    }
+    
+    DuplicateFilter::IMPL::IMPL( size_t maxBytes ):
+        _maxBytes(              maxBytes ),
+        _shards(                new Shard[ DuplicateFilterShards ] ),
+        _tableBytes(            0 ),
+        _bloomBlocks(           0 ),
+        _approximate(           false ),
+        _bloomItems(            0 ),
+        _duplicates(            0 ),
+        _approximateDuplicates( 0 ),
+        _unchecked(             0 )
+    {
+        size_t i;
+        
+        for( i = 0; i < DuplicateFilterShards; i++ )
+        {
+            this->_shards[ i ].used = 0;
+        }
+    }
+    
+    DuplicateFilter::IMPL::ShardResult DuplicateFilter::IMPL::shardInsert( Shard & shard, uint64_t fingerprint )
+    {
+        std::vector< uint64_t > table;
+        size_t                  capacity;
+        
+        if( shard.table.empty() || ( shard.used + 1 ) * 4 > shard.table.size() * 3 )
+        {
+            capacity = ( shard.table.empty() ) ? DuplicateFilterInitialCapacity : shard.table.size() * 2;
+            
+            if( this->_tableBytes + capacity * sizeof( uint64_t ) > this->_maxBytes )
+            {
+                return ShardResultFull;
+            }
+            
+            table.resize( capacity, 0 );
+            
+            for( uint64_t f: shard.table )
+            {
+                if( f != 0 )
+                {
+                    tableInsert( table, f );
+                }
+            }
+            
+            this->_tableBytes += ( capacity - shard.table.size() ) * sizeof( uint64_t );
+            
+            shard.table.swap( table );
+        }
+        
+        if( tableInsert( shard.table, fingerprint ) == false )
+        {
+            return ShardResultDuplicate;
+        }
+        
+        shard.used++;
+        
+        return ShardResultInserted;
+    }
+    
+    bool DuplicateFilter::IMPL::tableInsert( std::vector< uint64_t > & table, uint64_t fingerprint )
+    {
+        size_t mask;
+        size_t i;
+        
+        mask = table.size() - 1;
+        
+        for( i = static_cast< size_t >( fingerprint ) & mask; ; i = ( i + 1 ) & mask )
+        {
+            if( table[ i ] == fingerprint )
+            {
+                return false;
+            }
+            
+            if( table[ i ] == 0 )
+            {
+                table[ i ] = fingerprint;
+                
+                return true;
+            }
+        }
+    }
+    
+    bool DuplicateFilter::IMPL::bloomInsert( uint64_t fingerprint )
+    {
+        uint64_t bits;
+        uint64_t previous;
+        size_t   block;
+        size_t   bit;
+        size_t   i;
+        bool     inserted;
+        
+        if( this->_bloomItems >= this->_bloomBlocks * DuplicateFilterBlockWords * 64 / DuplicateFilterBitsPerItem )
+        {
+            this->_unchecked++;
+            
+            return true;
+        }
+        
+        block    = static_cast< size_t >( fingerprint ) & ( this->_bloomBlocks - 1 );
+        bits     = DuplicateFilterMix( fingerprint );
+        inserted = false;
+        
+        for( i = 0; i < DuplicateFilterHashes; i++ )
+        {
+            bit      = static_cast< size_t >( bits >> ( i * 9 ) ) & 511;
+            previous = this->_bloom[ block * DuplicateFilterBlockWords + bit / 64 ].fetch_or( 1ULL << ( bit % 64 ), std::memory_order_relaxed );
+            
+            if( ( previous & ( 1ULL << ( bit % 64 ) ) ) == 0 )
+            {
+                inserted = true;
+            }
+        }
+        
+        if( inserted )
+        {
+            this->_bloomItems++;
+        }
+        
+        return inserted;
+    }
+    
+    void DuplicateFilter::IMPL::convert( void )
+    {
+        std::lock_guard< std::mutex > l( this->_convertMtx );
+        size_t                        i;
+        
+        if( this->_approximate )
+        {
+            return;
+        }
+        
+        for( i = 0; i < DuplicateFilterShards; i++ )
+        {
+            this->_shards[ i ].mtx.lock();
+        }
+        
+        this->_bloomBlocks = 1;
+        
+        while( this->_bloomBlocks * 2 * DuplicateFilterBlockWords * sizeof( uint64_t ) <= this->_maxBytes )
+        {
+            this->_bloomBlocks *= 2;
+        }
+        
+        {
+            std::vector< std::atomic< uint64_t > > bloom( this->_bloomBlocks * DuplicateFilterBlockWords );
+            
+            this->_bloom.swap( bloom );
+        }
+        
+        for( i = 0; i < DuplicateFilterShards; i++ )
+        {
+            for( uint64_t f: this->_shards[ i ].table )
+            {
+                if( f != 0 )
+                {
+                    this->bloomInsert( f );
+                }
+            }
+            
+            std::vector< uint64_t >().swap( this->_shards[ i ].table );
+            
+            this->_shards[ i ].used = 0;
+        }
+        
+        this->_tableBytes = 0;
+        
+        this->_approximate.store( true, std::memory_order_release );
+        
+        for( i = 0; i < DuplicateFilterShards; i++ )
+        {
+            this->_shards[ i ].mtx.unlock();
+        }
+    }
+    
+    static uint64_t DuplicateFilterMix( uint64_t h )
+    {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        
+        return h;
+    }
+    
+    static uint64_t DuplicateFilterHash( const char * candidate, size_t length )
+    {
+        uint64_t h;
+        uint64_t word;
+        
+        h = DuplicateFilterMultiplier ^ length;
+        
+        while( length >= sizeof( uint64_t ) )
+        {
+            memcpy( &word, candidate, sizeof( uint64_t ) );
+            
+            h          = ( h ^ DuplicateFilterMix( word ) ) * DuplicateFilterMultiplier;
+            candidate += sizeof( uint64_t );
+            length    -= sizeof( uint64_t );
+        }
+        
+        word = 0;
+        
+        memcpy( &word, candidate, length );
+        
+        h = DuplicateFilterMix( h ^ DuplicateFilterMix( word ) );
+        
+        return ( h == 0 ) ? 1 : h;
+    }
+}
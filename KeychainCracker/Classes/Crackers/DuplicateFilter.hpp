@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      DuplicateFilter.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_DUPLICATE_FILTER_HPP
+#define XS_DUPLICATE_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace XS
+{
+    /*!
+     * Concurrent set of candidates already handed to the verifier.
+     * 
+     * Candidates are stored as 64-bit fingerprints in sharded, open
+     * addressing tables, each shard with its own lock. When the tables
+     * would outgrow the memory ceiling, every fingerprint is moved to a
+     * blocked Bloom filter of the same size (one cache line per lookup,
+     * lock-free).
+     * 
+     * The Bloom filter is approximate: at 16 bits per item and 7 hashes,
+     * about 0.1% of new candidates are rejected as false positives, and
+     * those passwords are never tried. Its rejections are counted apart by
+     * approximateDuplicates(), so a run that didn't find the password can
+     * say how many candidates were skipped that way. Once the filter holds
+     * one item per 16 bits, new candidates are let through unchecked, so
+     * the false positive rate doesn't grow any further.
+     */
+    class DuplicateFilter
+    {
+        public:
+            
+            DuplicateFilter( size_t maxBytes );
+            ~DuplicateFilter( void );
+            
+            DuplicateFilter( const DuplicateFilter & o )      = delete;
+            DuplicateFilter( DuplicateFilter && o )           = delete;
+            DuplicateFilter & operator =( DuplicateFilter o ) = delete;
+            
+            friend void swap( DuplicateFilter & o1, DuplicateFilter & o2 );
+            
+            bool insert( const char * candidate, size_t length );
+            
+            uint64_t duplicates( void )            const;
+            uint64_t approximateDuplicates( void ) const;
+            uint64_t unchecked( void )             const;
+            bool     isApproximate( void )         const;
+            size_t   memoryUsage( void )           const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_DUPLICATE_FILTER_HPP */
@@ -43,9 +43,31 @@ typedef NS_ENUM( NSInteger, GenericKeychainCrackerImplementation )
     GenericKeychainCrackerImplementationCXX,
 };
 
+typedef NS_ENUM( NSInteger, GenericKeychainCrackerHybridMode )
+{
+    GenericKeychainCrackerHybridModeNone,
+    GenericKeychainCrackerHybridModeAppend,
+    GenericKeychainCrackerHybridModePrepend,
+};
+
 @interface GenericKeychainCracker: NSObject < KeychainCracker >
 
+@property( atomic, readwrite, assign           ) BOOL                             adaptiveThreads;
+@property( atomic, readwrite, strong, nullable ) NSString                       * traceFile;
+@property( atomic, readonly,  nullable         ) NSString                       * hybridMask;
+@property( atomic, readonly                    ) GenericKeychainCrackerHybridMode hybridMode;
+@property( atomic, readwrite, assign           ) NSUInteger                       markovMinLength;
+@property( atomic, readwrite, assign           ) NSUInteger                       markovMaxLength;
+@property( atomic, readwrite, assign           ) NSUInteger                       markovThreshold;
+@property( atomic, readwrite, assign           ) NSUInteger                       deduplicationMemory;
+@property( atomic, readonly                    ) NSUInteger                       duplicatesSkipped;
+@property( atomic, readonly,  nullable         ) NSString                       * error;
+
 - ( nullable instancetype )initWithKeychain: ( NSString * )keychain passwords: ( NSArray< NSString * > * )passwords implementation: ( GenericKeychainCrackerImplementation )imp NS_DESIGNATED_INITIALIZER;
+- ( nullable instancetype )initWithKeychain: ( NSString * )keychain wordList: ( NSString * )wordList implementation: ( GenericKeychainCrackerImplementation )imp NS_DESIGNATED_INITIALIZER;
+
+- ( BOOL )setHybridMask: ( nullable NSString * )mask mode: ( GenericKeychainCrackerHybridMode )mode;
+- ( BOOL )setConstraintsWithMinLength: ( NSUInteger )minLength maxLength: ( NSUInteger )maxLength required: ( nullable NSString * )required forbidden: ( nullable NSString * )forbidden prefix: ( nullable NSString * )prefix suffix: ( nullable NSString * )suffix pattern: ( nullable NSString * )pattern;
 
 @end
 
@@ -30,9 +30,12 @@
 #import "GenericKeychainCracker.h"
 #import "ConcreteKeychainCracker.h"
 #import "KeychainCracker.hpp"
+#import "CompiledWordList.hpp"
+#import "WordListStream.hpp"
 #import <list>
 #import <string>
 #import <iostream>
+#import <limits>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -43,6 +46,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property( atomic, readwrite, assign ) XS::KeychainCracker                * cxxCracker;
 
 - ( std::list< std::string > )stringArrayToStringList: ( NSArray< NSString * > * )array;
+- ( NSArray< NSString * > * )wordListToStringArray: ( NSString * )path;
 
 @end
 
@@ -61,13 +65,50 @@ NS_ASSUME_NONNULL_END
     {
         self.implementation = imp;
         
-        if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+        try
         {
-            self.objcCracker = [ [ ConcreteKeychainCracker alloc ] initWithKeychain: keychain passwords: passwords ];
+            if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+            {
+                self.objcCracker = [ [ ConcreteKeychainCracker alloc ] initWithKeychain: keychain passwords: passwords ];
+            }
+            else
+            {
+                self.cxxCracker = new XS::KeychainCracker( keychain.UTF8String, [ self stringArrayToStringList: passwords ] );
+            }
         }
-        else
+        catch( const std::exception & e )
         {
-            self.cxxCracker = new XS::KeychainCracker( keychain.UTF8String, [ self stringArrayToStringList: passwords ] );
+            NSLog( @"%s", e.what() );
+            
+            return nil;
+        }
+    }
+    
+    return self;
+}
+
+- ( nullable instancetype )initWithKeychain: ( NSString * )keychain wordList: ( NSString * )wordList implementation: ( GenericKeychainCrackerImplementation )imp
+{
+    if( ( self = [ super init ] ) )
+    {
+        self.implementation = imp;
+        
+        try
+        {
+            if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+            {
+                self.objcCracker = [ [ ConcreteKeychainCracker alloc ] initWithKeychain: keychain passwords: [ self wordListToStringArray: wordList ] ];
+            }
+            else
+            {
+                self.cxxCracker = new XS::KeychainCracker( keychain.UTF8String, std::string( wordList.UTF8String ) );
+            }
+        }
+        catch( const std::exception & e )
+        {
+            NSLog( @"%s", e.what() );
+            
+            return nil;
         }
     }
     
@@ -97,6 +138,52 @@ NS_ASSUME_NONNULL_END
     return l;
 }
 
+- ( NSArray< NSString * > * )wordListToStringArray: ( NSString * )path
+{
+    NSString                     * str;
+    NSMutableArray< NSString * > * array;
+    size_t                         i;
+    
+    array = [ NSMutableArray new ];
+    
+    if( XS::CompiledWordList::isCompiledWordList( path.UTF8String ) )
+    {
+        XS::CompiledWordList list( path.UTF8String );
+        
+        for( i = 0; i < list.count(); i++ )
+        {
+            str = [ [ NSString alloc ] initWithBytes: list.word( i ) length: list.length( i ) encoding: NSUTF8StringEncoding ];
+            
+            if( str != nil )
+            {
+                [ array addObject: str ];
+            }
+        }
+    }
+    else
+    {
+        XS::WordListStream stream( path.UTF8String );
+        XS::CandidateBatch batch;
+        
+        stream.restart();
+        
+        while( stream.next( batch, 1024 ) )
+        {
+            for( i = 0; i < batch.count(); i++ )
+            {
+                str = [ [ NSString alloc ] initWithBytes: batch.candidate( i ) length: batch.length( i ) encoding: NSUTF8StringEncoding ];
+                
+                if( str != nil )
+                {
+                    [ array addObject: str ];
+                }
+            }
+        }
+    }
+    
+    return array;
+}
+
 - ( void )crack: ( void ( ^ )( BOOL passwordFound, NSString * _Nullable password ) )completion
 {
     if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
@@ -177,6 +264,173 @@ NS_ASSUME_NONNULL_END
     return self.cxxCracker->maxThreads();
 }
 
+- ( BOOL )adaptiveThreads
+{
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+    {
+        return NO;
+    }
+    
+    return self.cxxCracker->adaptiveThreads();
+}
+
+- ( nullable NSString * )traceFile
+{
+    std::string path;
+    
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+    {
+        return nil;
+    }
+    
+    path = self.cxxCracker->traceFile();
+    
+    return ( path.length() ) ? [ NSString stringWithUTF8String: path.c_str() ] : nil;
+}
+
+- ( nullable NSString * )hybridMask
+{
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+    {
+        return nil;
+    }
+    
+    return [ NSString stringWithUTF8String: self.cxxCracker->hybridMask().c_str() ];
+}
+
+- ( GenericKeychainCrackerHybridMode )hybridMode
+{
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+    {
+        return GenericKeychainCrackerHybridModeNone;
+    }
+    
+    switch( self.cxxCracker->hybridMode() )
+    {
+        case XS::KeychainCracker::HybridModeAppend:  return GenericKeychainCrackerHybridModeAppend;
+        case XS::KeychainCracker::HybridModePrepend: return GenericKeychainCrackerHybridModePrepend;
+        case XS::KeychainCracker::HybridModeNone:    break;
+    }
+    
+    return GenericKeychainCrackerHybridModeNone;
+}
+
+- ( BOOL )setHybridMask: ( nullable NSString * )mask mode: ( GenericKeychainCrackerHybridMode )mode
+{
+    XS::KeychainCracker::HybridMode m;
+    
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+    {
+        return mode == GenericKeychainCrackerHybridModeNone;
+    }
+    
+    switch( mode )
+    {
+        case GenericKeychainCrackerHybridModeAppend:  m = XS::KeychainCracker::HybridModeAppend;  break;
+        case GenericKeychainCrackerHybridModePrepend: m = XS::KeychainCracker::HybridModePrepend; break;
+        case GenericKeychainCrackerHybridModeNone:    m = XS::KeychainCracker::HybridModeNone;    break;
+    }
+    
+    try
+    {
+        self.cxxCracker->hybridMask( ( mask.length ) ? mask.UTF8String : "", m );
+    }
+    catch( ... )
+    {
+        return NO;
+    }
+    
+    return YES;
+}
+
+- ( BOOL )setConstraintsWithMinLength: ( NSUInteger )minLength maxLength: ( NSUInteger )maxLength required: ( nullable NSString * )required forbidden: ( nullable NSString * )forbidden prefix: ( nullable NSString * )prefix suffix: ( nullable NSString * )suffix pattern: ( nullable NSString * )pattern
+{
+    XS::Constraints constraints;
+    
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+    {
+        return NO;
+    }
+    
+    try
+    {
+        constraints.length( minLength, ( maxLength > 0 ) ? maxLength : std::numeric_limits< size_t >::max() );
+        constraints.required( XS::Constraints::classes( ( required.length ) ? required.UTF8String : "" ) );
+        constraints.forbidden( XS::Constraints::classes( ( forbidden.length ) ? forbidden.UTF8String : "" ) );
+        constraints.prefix( ( prefix.length ) ? prefix.UTF8String : "" );
+        constraints.suffix( ( suffix.length ) ? suffix.UTF8String : "" );
+        constraints.pattern( ( pattern.length ) ? pattern.UTF8String : "" );
+    }
+    catch( ... )
+    {
+        return NO;
+    }
+    
+    self.cxxCracker->constraints( constraints );
+    
+    return YES;
+}
+
+- ( NSUInteger )markovMinLength
+{
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+    {
+        return 0;
+    }
+    
+    return self.cxxCracker->markovMinLength();
+}
+
+- ( NSUInteger )markovMaxLength
+{
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+    {
+        return 0;
+    }
+    
+    return self.cxxCracker->markovMaxLength();
+}
+
+- ( NSUInteger )markovThreshold
+{
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+    {
+        return 0;
+    }
+    
+    return self.cxxCracker->markovThreshold();
+}
+
+- ( NSUInteger )deduplicationMemory
+{
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+    {
+        return 0;
+    }
+    
+    return self.cxxCracker->deduplicationMemory();
+}
+
+- ( NSUInteger )duplicatesSkipped
+{
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
+    {
+        return 0;
+    }
+    
+    return self.cxxCracker->duplicatesSkipped();
+}
+
+- ( nullable NSString * )error
+{
+    if( self.implementation == GenericKeychainCrackerImplementationObjectiveC || self.cxxCracker->error().empty() )
+    {
+        return nil;
+    }
+    
+    return [ NSString stringWithUTF8String: self.cxxCracker->error().c_str() ];
+}
+
 - ( NSUInteger )maxCharsForCaseVariants
 {
     if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
@@ -209,6 +463,54 @@ NS_ASSUME_NONNULL_END
     }
 }
 
+- ( void )setAdaptiveThreads: ( BOOL )value
+{
+    if( self.implementation == GenericKeychainCrackerImplementationCXX )
+    {
+        self.cxxCracker->adaptiveThreads( value );
+    }
+}
+
+- ( void )setTraceFile: ( nullable NSString * )value
+{
+    if( self.implementation == GenericKeychainCrackerImplementationCXX )
+    {
+        self.cxxCracker->traceFile( ( value.length ) ? value.stringByExpandingTildeInPath.UTF8String : "" );
+    }
+}
+
+- ( void )setMarkovMinLength: ( NSUInteger )value
+{
+    if( self.implementation == GenericKeychainCrackerImplementationCXX )
+    {
+        self.cxxCracker->markovLength( value, self.cxxCracker->markovMaxLength() );
+    }
+}
+
+- ( void )setMarkovMaxLength: ( NSUInteger )value
+{
+    if( self.implementation == GenericKeychainCrackerImplementationCXX )
+    {
+        self.cxxCracker->markovLength( self.cxxCracker->markovMinLength(), value );
+    }
+}
+
+- ( void )setMarkovThreshold: ( NSUInteger )value
+{
+    if( self.implementation == GenericKeychainCrackerImplementationCXX )
+    {
+        self.cxxCracker->markovThreshold( static_cast< unsigned int >( value ) );
+    }
+}
+
+- ( void )setDeduplicationMemory: ( NSUInteger )value
+{
+    if( self.implementation == GenericKeychainCrackerImplementationCXX )
+    {
+        self.cxxCracker->deduplicationMemory( value );
+    }
+}
+
 - ( void )setMaxCharsForCaseVariants: ( NSUInteger )value
 {
     if( self.implementation == GenericKeychainCrackerImplementationObjectiveC )
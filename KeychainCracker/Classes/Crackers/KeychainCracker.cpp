@@ -28,61 +28,120 @@
  */
 
 #include "KeychainCracker.hpp"
+#include "CompiledWordList.hpp"
+#include "WordListStream.hpp"
+#include "CompiledWordListSource.hpp"
+#include "PasswordListSource.hpp"
+#include "ConcurrencyController.hpp"
+#include "TraceRecorder.hpp"
+#include "PasswordVariants.hpp"
+#include "HybridSource.hpp"
+#include "VariantSource.hpp"
+#include "Mask.hpp"
+#include "MarkovModel.hpp"
+#include "MarkovSource.hpp"
+#include "DuplicateFilter.hpp"
+#include "KeychainTarget.hpp"
+#include "KeychainVerifier.hpp"
+#include "VerifierContext.hpp"
 #include <exception>
 #include <algorithm>
 #include <mutex>
 #include <atomic>
 #include <thread>
-#include <map>
 #include <chrono>
 #include <iostream>
+#include <limits>
+#include <vector>
 #include <Security/Security.h>
 
 namespace XS
 {
+    static const size_t KeychainCrackerBatchSize           = 256;
+    static const size_t KeychainCrackerVariantsChunkSize   = 256;
+    static const size_t KeychainCrackerDeduplicationMemory = 64 * 1024 * 1024;
+    
     class KeychainCracker::IMPL
     {
         public:
             
-            IMPL( const std::string & keychain, const std::list< std::string > & passwords );
+            IMPL( const std::string & keychain, const std::list< std::string > & passwords, const std::string & wordList = "" );
             ~IMPL( void );
             
-            std::string                  _keychainName;
-            std::list< std::string >     _passwords;
-            std::list< std::string >     _foundPasswords;
-            SecKeychainRef               _keychain;
-            std::atomic< unsigned long > _processed;
-            std::atomic< bool >          _unlocked;
-            std::atomic< bool >          _initialized;
-            std::atomic< bool >          _stopping;
-            std::atomic< bool >          _running;
-            std::atomic< size_t >        _threadsRunning;
-            std::atomic< size_t >        _secondsRemaining;
-            std::atomic< size_t >        _numberOfPasswordsToTest;
-            std::string                  _message;
-            std::atomic< double >        _progress;
-            std::atomic< bool >          _progressIsIndeterminate;
-            std::atomic< size_t >        _lastProcessed;
-            std::recursive_mutex         _rmtx;
-            std::atomic< size_t >        _maxThreads;
-            std::atomic< size_t >        _maxCharsForCaseVariants;
-            std::atomic< size_t >        _maxCharsForCommonSubstitutions;
+            std::string                      _keychainName;
+            std::list< std::string >         _passwords;
+            CompiledWordList               * _wordList;
+            MarkovModel                    * _markov;
+            WordListStream                 * _stream;
+            CandidateSource                * _runSource;
+            CandidateSource                * _source;
+            ConcurrencyController          * _controller;
+            DuplicateFilter                * _filter;
+            TraceRecorder                  * _tracer;
+            std::string                      _traceFile;
+            std::string                      _hybridMask;
+            HybridMode                       _hybridMode;
+            Constraints                      _constraints;
+            Constraints                      _runConstraints;
+            std::list< std::string >         _foundPasswords;
+            SecKeychainRef                   _keychain;
+            KeychainTarget                 * _target;
+            KeychainVerifier               * _verifier;
+            std::vector< VerifierContext * > _contexts;
+            std::atomic< unsigned long >     _processed;
+            std::atomic< bool >              _unlocked;
+            std::atomic< bool >              _initialized;
+            std::atomic< bool >              _stopping;
+            std::atomic< bool >              _running;
+            std::atomic< bool >              _exhausted;
+            std::atomic< size_t >            _threadsRunning;
+            std::atomic< size_t >            _secondsRemaining;
+            std::atomic< size_t >            _numberOfPasswordsToTest;
+            std::string                      _message;
+            std::string                      _error;
+            std::atomic< double >            _progress;
+            std::atomic< bool >              _progressIsIndeterminate;
+            std::atomic< size_t >            _lastProcessed;
+            std::recursive_mutex             _rmtx;
+            std::atomic< size_t >            _maxThreads;
+            std::atomic< size_t >            _maxCharsForCaseVariants;
+            std::atomic< size_t >            _maxCharsForCommonSubstitutions;
+            std::atomic< bool >              _adaptiveThreads;
+            std::atomic< size_t >            _markovMinLength;
+            std::atomic< size_t >            _markovMaxLength;
+            std::atomic< unsigned int >      _markovThreshold;
+            std::atomic< size_t >            _deduplicationMemory;
+            std::atomic< unsigned long >     _duplicates;
+            std::thread                      _crackThread;
+            std::thread                      _progressThread;
             
             std::function< void( bool, const std::string & ) > _completion;
             
             void crack( void );
-            void generateVariants( std::list< std::string > & passwords, std::list< std::string > ( IMPL::* func )( const std::string & ), size_t maxChars, const std::string & message );
-            void crackPasswords( const std::list< std::string > & passwords );
+            void generateVariants( std::list< std::string > & passwords, const std::function< std::list< std::string >( const std::string & ) > & func, size_t maxChars, const std::string & message );
+            void crackSource( void );
+            bool readStream( std::list< std::string > & passwords );
+            void useSource( const std::list< std::string > & passwords, bool variants );
+            void crackSourceBatches( size_t worker );
+            bool tryPassword( const char * password, size_t length, VerifierContext * context );
+            bool unlock( const char * password, size_t length, VerifierContext * context );
             void checkProgress( void );
+            void join( void );
+            void fail( const std::string & error );
+            
+            std::string threadsDescription( void )    const;
+            std::string duplicatesDescription( void ) const;
             
-            std::list< std::string > caseVariants( const std::string & str );
-            std::list< std::string > commonSubstitutions( const std::string & str );
     };
     
     KeychainCracker::KeychainCracker( const std::string & keychain, const std::list< std::string > & passwords ):
         impl( new IMPL( keychain, passwords ) )
     {}
     
+    KeychainCracker::KeychainCracker( const std::string & keychain, const std::string & wordList ):
+        impl( new IMPL( keychain, {}, wordList ) )
+    {}
+    
     KeychainCracker::~KeychainCracker( void )
     {
         delete this->impl;
@@ -102,6 +161,13 @@ namespace XS
         return this->impl->_message;
     }
     
+    std::string KeychainCracker::error( void ) const
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        
+        return this->impl->_error;
+    }
+    
     double KeychainCracker::progress( void ) const
     {
         std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
@@ -123,6 +189,11 @@ namespace XS
         return this->impl->_secondsRemaining;
     }
     
+    unsigned long KeychainCracker::candidatesTried( void ) const
+    {
+        return this->impl->_processed;
+    }
+    
     void KeychainCracker::crack( const std::function< void( bool, const std::string & ) > & completion )
     {
         std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
@@ -134,26 +205,31 @@ namespace XS
         
         this->impl->_running                 = true;
         this->impl->_completion              = completion;
+        this->impl->_error                   = "";
         this->impl->_initialized             = false;
         this->impl->_progressIsIndeterminate = true;
         
-        std::thread
+        delete this->impl->_tracer;
+        
+        this->impl->_tracer = ( this->impl->_traceFile.empty() ) ? nullptr : new TraceRecorder();
+        
+        this->impl->join();
+        
+        this->impl->_crackThread = std::thread
         (
             [ this ]
             {
                 this->impl->crack();
             }
-        )
-        .detach();
+        );
         
-        std::thread
+        this->impl->_progressThread = std::thread
         (
             [ this ]
             {
                 this->impl->checkProgress();
             }
-        )
-        .detach();
+        );
     }
     
     void KeychainCracker::stop( void )
@@ -168,7 +244,113 @@ namespace XS
         this->impl->_stopping                = true;
         this->impl->_progressIsIndeterminate = true;
     }
-            
+    
+    std::string KeychainCracker::traceFile( void ) const
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        
+        return this->impl->_traceFile;
+    }
+    
+    void KeychainCracker::traceFile( const std::string & path )
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        
+        this->impl->_traceFile = path;
+    }
+    
+    KeychainCracker::HybridMode KeychainCracker::hybridMode( void ) const
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        
+        return this->impl->_hybridMode;
+    }
+    
+    std::string KeychainCracker::hybridMask( void ) const
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        
+        return this->impl->_hybridMask;
+    }
+    
+    void KeychainCracker::hybridMask( const std::string & mask, HybridMode mode )
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        
+        if( mode != HybridModeNone )
+        {
+            Mask( mask ).count();
+        }
+        
+        this->impl->_hybridMask = mask;
+        this->impl->_hybridMode = mode;
+    }
+    
+    size_t KeychainCracker::markovMinLength( void ) const
+    {
+        return this->impl->_markovMinLength;
+    }
+    
+    size_t KeychainCracker::markovMaxLength( void ) const
+    {
+        return this->impl->_markovMaxLength;
+    }
+    
+    unsigned int KeychainCracker::markovThreshold( void ) const
+    {
+        return this->impl->_markovThreshold;
+    }
+    
+    void KeychainCracker::markovLength( size_t minLength, size_t maxLength )
+    {
+        this->impl->_markovMinLength = minLength;
+        this->impl->_markovMaxLength = maxLength;
+    }
+    
+    void KeychainCracker::markovThreshold( unsigned int value )
+    {
+        this->impl->_markovThreshold = value;
+    }
+    
+    Constraints KeychainCracker::constraints( void ) const
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        
+        return this->impl->_constraints;
+    }
+    
+    void KeychainCracker::constraints( const Constraints & value )
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        
+        this->impl->_constraints = value;
+    }
+    
+    size_t KeychainCracker::deduplicationMemory( void ) const
+    {
+        return this->impl->_deduplicationMemory;
+    }
+    
+    unsigned long KeychainCracker::duplicatesSkipped( void ) const
+    {
+        return this->impl->_duplicates;
+    }
+    
+    void KeychainCracker::deduplicationMemory( size_t bytes )
+    {
+        this->impl->_deduplicationMemory = bytes;
+    }
+    
+    bool KeychainCracker::adaptiveThreads( void ) const
+    {
+        return this->impl->_adaptiveThreads;
+    }
+    
+    void KeychainCracker::adaptiveThreads( bool value )
+    {
+        this->impl->_adaptiveThreads = value;
+    }
+    
     size_t KeychainCracker::maxThreads( void ) const
     {
         return this->impl->_maxThreads;
@@ -199,15 +381,27 @@ namespace XS
         this->impl->_maxCharsForCommonSubstitutions = value;
     }
     
-    KeychainCracker::IMPL::IMPL( const std::string & keychain, const std::list< std::string > & passwords ):
+    KeychainCracker::IMPL::IMPL( const std::string & keychain, const std::list< std::string > & passwords, const std::string & wordList ):
         _keychainName(                   keychain ),
         _passwords(                      passwords ),
+        _wordList(                       nullptr ),
+        _markov(                         nullptr ),
+        _stream(                         nullptr ),
+        _runSource(                      nullptr ),
+        _source(                         nullptr ),
+        _controller(                     nullptr ),
+        _filter(                         nullptr ),
+        _tracer(                         nullptr ),
+        _hybridMode(                     HybridModeNone ),
         _keychain(                       nullptr ),
+        _target(                         nullptr ),
+        _verifier(                       nullptr ),
         _processed(                      0 ),
         _unlocked(                       false ),
         _initialized(                    false ),
         _stopping(                       false ),
         _running(                        false ),
+        _exhausted(                      false ),
         _threadsRunning(                 0 ),
         _secondsRemaining(               0 ),
         _numberOfPasswordsToTest(        0 ),
@@ -216,10 +410,53 @@ namespace XS
         _lastProcessed(                  0 ),
         _maxThreads(                     0 ),
         _maxCharsForCaseVariants(        0 ),
-        _maxCharsForCommonSubstitutions( 0 )
+        _maxCharsForCommonSubstitutions( 0 ),
+        _adaptiveThreads(                false ),
+        _markovMinLength(                1 ),
+        _markovMaxLength(                8 ),
+        _markovThreshold(                40 ),
+        _deduplicationMemory(            KeychainCrackerDeduplicationMemory ),
+        _duplicates(                     0 )
     {
+        if( wordList.length() > 0 && CompiledWordList::isCompiledWordList( wordList ) )
+        {
+            this->_wordList = new CompiledWordList( wordList );
+        }
+        else if( wordList.length() > 0 && MarkovModel::isMarkovModel( wordList ) )
+        {
+            this->_markov = new MarkovModel( wordList );
+        }
+        else if( wordList.length() > 0 )
+        {
+            this->_stream = new WordListStream( wordList );
+        }
+        
+        if( KeychainTarget::isTarget( this->_keychainName ) )
+        {
+            try
+            {
+                this->_target   = new KeychainTarget( this->_keychainName );
+                this->_verifier = new KeychainVerifier( *( this->_target ) );
+            }
+            catch( ... )
+            {
+                delete this->_target;
+                delete this->_wordList;
+                delete this->_markov;
+                delete this->_stream;
+                
+                throw;
+            }
+            
+            return;
+        }
+        
         if( SecKeychainOpen( this->_keychainName.c_str(), &( this->_keychain ) ) != noErr || this->_keychain == NULL )
         {
+            delete this->_wordList;
+            delete this->_markov;
+            delete this->_stream;
+            
             throw std::runtime_error( std::string( "Cannot open keychain" ) + this->_keychainName );
         }
         
@@ -228,26 +465,174 @@ namespace XS
     
     KeychainCracker::IMPL::~IMPL( void )
     {
+        this->_stopping = true;
+        
+        this->join();
+        
         if( this->_keychain != nullptr )
         {
             CFRelease( this->_keychain );
         }
+        
+        delete this->_verifier;
+        delete this->_target;
+        delete this->_wordList;
+        delete this->_markov;
+        delete this->_stream;
+        delete this->_runSource;
+        delete this->_controller;
+        delete this->_filter;
+        delete this->_tracer;
     }
     
     void KeychainCracker::IMPL::crack( void )
     {
-        std::list< std::string >              passwords;
-        std::list< std::list< std::string > > groups;
-        unsigned long                         n;
-        unsigned long                         i;
-        std::list< std::thread >              threads;
+        std::list< std::string > passwords;
+        size_t                   i;
         
-        passwords               = this->_passwords;
         this->_secondsRemaining = 0;
         
+        if( this->_tracer != nullptr )
+        {
+            this->_tracer->threadName( "Setup" );
+        }
+        
+        delete this->_runSource;
+        delete this->_filter;
+        
+        this->_runSource  = nullptr;
+        this->_source     = nullptr;
+        this->_filter     = nullptr;
+        this->_duplicates = 0;
+        
+        {
+            std::lock_guard< std::recursive_mutex > l( this->_rmtx );
+            
+            this->_runConstraints = this->_constraints;
+        }
+        
+        if( this->_runConstraints.empty() == false )
+        {
+            std::clog << "KeychainCracker: Constraints: " << this->_runConstraints.description() << std::endl;
+        }
+        
+        if( this->_markov != nullptr )
+        {
+            this->useSource( {}, false );
+            
+            return;
+        }
+        
+        if( this->_stream != nullptr && this->_hybridMode == HybridModeNone )
+        {
+            this->_source = this->_stream;
+            
+            this->crackSource();
+            
+            if( this->_stream->error().empty() == false )
+            {
+                this->fail( this->_stream->error() );
+            }
+            
+            return;
+        }
+        
+        if( this->_wordList != nullptr && this->_maxCharsForCaseVariants == 0 && this->_maxCharsForCommonSubstitutions == 0 && ( this->_runConstraints.empty() || this->_hybridMode != HybridModeNone ) )
+        {
+            this->useSource( {}, false );
+            
+            return;
+        }
+        
+        if( this->_hybridMode == HybridModeNone && this->_runConstraints.empty() )
+        {
+            if( this->_wordList != nullptr )
+            {
+                this->useSource( {}, true );
+            }
+            else
+            {
+                this->useSource( this->_passwords, true );
+            }
+            
+            return;
+        }
+        
+        if( this->_wordList != nullptr )
+        {
+            for( i = 0; i < this->_wordList->count(); i++ )
+            {
+                passwords.push_back( this->_wordList->string( i ) );
+            }
+        }
+        else if( this->_stream != nullptr && this->readStream( passwords ) == false )
+        {
+            this->_initialized = true;
+            
+            return;
+        }
+        else
+        {
+            passwords = this->_passwords;
+        }
+        
+        if( this->_runConstraints.empty() == false && this->_hybridMode == HybridModeNone )
+        {
+            TraceRecorder::Span span( this->_tracer, "generate variants", passwords.size() );
+            
+            if( this->_maxCharsForCaseVariants > 0 || this->_maxCharsForCommonSubstitutions > 0 )
+            {
+                this->generateVariants
+                (
+                    passwords,
+                    [ this ]( const std::string & password )
+                    {
+                        return PasswordVariants::expand( password, this->_maxCharsForCaseVariants, this->_maxCharsForCommonSubstitutions, this->_runConstraints );
+                    },
+                    std::numeric_limits< size_t >::max(),
+                    "Generating constrained variants"
+                );
+            }
+            else
+            {
+                this->generateVariants
+                (
+                    passwords,
+                    [ this ]( const std::string & password )
+                    {
+                        return ( this->_runConstraints.accepts( password.c_str(), password.length() ) ) ? std::list< std::string >{ password } : std::list< std::string >{};
+                    },
+                    std::numeric_limits< size_t >::max(),
+                    "Applying constraints"
+                );
+            }
+            
+            if( this->_stopping == false )
+            {
+                this->useSource( passwords, false );
+            }
+            else
+            {
+                this->_initialized = true;
+            }
+            
+            return;
+        }
+        
         if( this->_maxCharsForCaseVariants > 0 )
         {
-            this->generateVariants( passwords, &IMPL::caseVariants, this->_maxCharsForCaseVariants, "Generating case variants" );
+            TraceRecorder::Span span( this->_tracer, "generate variants", passwords.size() );
+            
+            this->generateVariants
+            (
+                passwords,
+                []( const std::string & password )
+                {
+                    return PasswordVariants::caseVariants( password );
+                },
+                this->_maxCharsForCaseVariants,
+                "Generating case variants"
+            );
         }
         
         if( this->_stopping )
@@ -259,7 +644,18 @@ namespace XS
         
         if( this->_maxCharsForCommonSubstitutions > 0 )
         {
-            this->generateVariants( passwords, &IMPL::commonSubstitutions, this->_maxCharsForCommonSubstitutions, "Generating common substitutions" );
+            TraceRecorder::Span span( this->_tracer, "generate variants", passwords.size() );
+            
+            this->generateVariants
+            (
+                passwords,
+                []( const std::string & password )
+                {
+                    return PasswordVariants::commonSubstitutions( password );
+                },
+                this->_maxCharsForCommonSubstitutions,
+                "Generating common substitutions"
+            );
         }
         
         if( this->_stopping )
@@ -269,182 +665,407 @@ namespace XS
             return;
         }
         
+        this->useSource( passwords, false );
+    }
+    
+    bool KeychainCracker::IMPL::readStream( std::list< std::string > & passwords )
+    {
+        CandidateBatch batch;
+        size_t         i;
+        
         {
             std::lock_guard< std::recursive_mutex > l( this->_rmtx );
             
-            this->_message = "Preparing worker threads";
+            this->_message = "Reading word list";
         }
         
-        this->_numberOfPasswordsToTest = passwords.size();
-        this->_processed               = 0;
-        this->_progress                = 0;
-        n                              = ( passwords.size() / this->_maxThreads );
+        this->_stream->restart();
         
-        for( i = 0; i < this->_maxThreads; i++ )
+        while( this->_stopping == false && this->_stream->next( batch, KeychainCrackerBatchSize ) )
         {
+            for( i = 0; i < batch.count(); i++ )
             {
-                std::list< std::string > sub;
-                
-                if( passwords.size() < n )
-                {
-                    break;
-                }
-                
-                sub = std::list< std::string >( passwords.begin(), std::next( passwords.begin(), static_cast< long >( n ) ) );
-                
-                passwords.erase( passwords.begin(), std::next( passwords.begin(), static_cast< long >( n ) ) );
-                groups.push_back( sub );
+                passwords.push_back( std::string( batch.candidate( i ), batch.length( i ) ) );
             }
         }
         
-        if( this->_stopping )
+        if( this->_stream->error().empty() == false )
         {
-            this->_initialized = true;
+            this->fail( this->_stream->error() );
             
-            return;
+            return false;
         }
         
-        for( auto & sub: groups )
+        return true;
+    }
+    
+    void KeychainCracker::IMPL::useSource( const std::list< std::string > & passwords, bool variants )
+    {
+        std::string         mask;
+        HybridMode          mode;
+        const Constraints * constraints;
+        
+        constraints = ( this->_runConstraints.empty() ) ? nullptr : &( this->_runConstraints );
+        
         {
-            if( passwords.size() == 0 )
-            {
-                break;
-            }
+            std::lock_guard< std::recursive_mutex > l( this->_rmtx );
             
-            sub.push_back( *( passwords.begin() ) );
-            passwords.erase( passwords.begin() );
+            mask = this->_hybridMask;
+            mode = this->_hybridMode;
         }
         
-        if( this->_stopping )
+        try
         {
+            if( this->_markov != nullptr )
+            {
+                this->_runSource = new MarkovSource( *( this->_markov ), this->_markovMinLength, this->_markovMaxLength, this->_markovThreshold, constraints );
+            }
+            else if( mode != HybridModeNone )
+            {
+                this->_runSource = ( this->_wordList != nullptr && passwords.empty() )
+                                 ? new HybridSource( *( this->_wordList ), mask, ( mode == HybridModeAppend ) ? HybridSource::ModeAppend : HybridSource::ModePrepend, constraints )
+                                 : new HybridSource( passwords,            mask, ( mode == HybridModeAppend ) ? HybridSource::ModeAppend : HybridSource::ModePrepend, constraints );
+            }
+            else if( variants )
+            {
+                this->_runSource = ( this->_wordList != nullptr && passwords.empty() )
+                                 ? new VariantSource( *( this->_wordList ), this->_maxCharsForCaseVariants, this->_maxCharsForCommonSubstitutions )
+                                 : new VariantSource( passwords,            this->_maxCharsForCaseVariants, this->_maxCharsForCommonSubstitutions );
+            }
+            else if( this->_wordList != nullptr && passwords.empty() )
+            {
+                this->_runSource = new CompiledWordListSource( *( this->_wordList ) );
+            }
+            else
+            {
+                this->_runSource = new PasswordListSource( passwords );
+            }
+        }
+        catch( const std::exception & e )
+        {
+            this->fail( e.what() );
+            
             this->_initialized = true;
             
             return;
         }
         
-        for( const auto & sub: groups )
+        this->_source = this->_runSource;
+        
+        this->crackSource();
+    }
+    
+    void KeychainCracker::IMPL::generateVariants( std::list< std::string > & passwords, const std::function< std::list< std::string >( const std::string & ) > & func, size_t maxChars, const std::string & message )
+    {
+        std::vector< std::string >              words;
+        std::vector< std::list< std::string > > chunks;
+        std::atomic< size_t >                   next;
+        std::atomic< size_t >                   done;
+        std::list< std::thread >                threads;
+        size_t                                  i;
+        size_t                                  n;
+        time_t                                  start;
+        std::function< void( size_t ) >         expand;
+        
+        words.reserve( passwords.size() );
+        
+        for( auto & password: passwords )
         {
-            if( sub.size() == 0 )
+            words.push_back( std::move( password ) );
+        }
+        
+        passwords.clear();
+        chunks.resize( ( words.size() + KeychainCrackerVariantsChunkSize - 1 ) / KeychainCrackerVariantsChunkSize );
+        
+        next                           = 0;
+        done                           = 0;
+        n                              = std::min( std::max( this->_maxThreads.load(), static_cast< size_t >( 1 ) ), chunks.size() );
+        this->_progress                = 0;
+        this->_progressIsIndeterminate = false;
+        start                          = time( nullptr );
+        
+        expand = [ & ]( size_t worker )
+        {
+            size_t chunk;
+            size_t j;
+            double diff;
+            char   percent[ 4 ] = { 0, 0, 0, 0 };
+            
+            if( this->_tracer != nullptr && worker > 0 )
             {
-                continue;
+                this->_tracer->threadName( "Variants " + std::to_string( worker ) );
             }
             
-            threads.push_back
-            (
-                std::thread
-                (
-                    [ this, sub ]
+            while( this->_stopping == false )
+            {
+                chunk = next++;
+                
+                if( chunk >= chunks.size() )
+                {
+                    break;
+                }
+                
+                {
+                    TraceRecorder::Span span( this->_tracer, "expand chunk" );
+                    
+                    for( j = chunk * KeychainCrackerVariantsChunkSize; j < std::min( ( chunk + 1 ) * KeychainCrackerVariantsChunkSize, words.size() ); j++ )
                     {
-                        this->crackPasswords( sub );
+                        if( words[ j ].length() > maxChars )
+                        {
+                            chunks[ chunk ].push_back( std::move( words[ j ] ) );
+                        }
+                        else
+                        {
+                            chunks[ chunk ].splice( chunks[ chunk ].end(), func( words[ j ] ) );
+                        }
                     }
-                )
-            );
+                    
+                    span.count( chunks[ chunk ].size() );
+                }
+                
+                done += std::min( KeychainCrackerVariantsChunkSize, words.size() - chunk * KeychainCrackerVariantsChunkSize );
+                
+                if( worker == 0 )
+                {
+                    std::lock_guard< std::recursive_mutex > l( this->_rmtx );
+                    
+                    this->_progress = static_cast< double >( done ) / static_cast< double >( words.size() );
+                    
+                    snprintf( percent, sizeof(percent), "%.0f", this->_progress * 100 );
+                    
+                    this->_message          = message + " - " + percent + "%";
+                    diff                    = static_cast< double >( time( nullptr ) - start );
+                    this->_secondsRemaining = ( diff > 0 ) ? static_cast< unsigned long >( static_cast< double >( words.size() - done ) / ( static_cast< double >( done ) / diff ) ) : 0;
+                }
+            }
+        };
+        
+        for( i = 1; i < n; i++ )
+        {
+            threads.push_back( std::thread( expand, i ) );
         }
         
-        this->_initialized             = true;
-        this->_progressIsIndeterminate = false;
+        expand( 0 );
         
         for( auto & t: threads )
         {
             t.join();
         }
+        
+        for( auto & chunk: chunks )
+        {
+            passwords.splice( passwords.end(), chunk );
+        }
+        
+        this->_progressIsIndeterminate = true;
     }
     
-    void KeychainCracker::IMPL::generateVariants( std::list< std::string > & passwords, std::list< std::string > ( IMPL::* func )( const std::string & ), size_t maxChars, const std::string & message )
+    void KeychainCracker::IMPL::crackSource( void )
     {
+        std::list< std::thread > threads;
         size_t                   i;
-        size_t                   n;
-        std::list< std::string > variants;
-        time_t                   start;
-        double                   diff;
-        std::string              password;
-        char                     percent[ 4 ] = { 0, 0, 0, 0 };
-        
-        n                              = passwords.size();
-        this->_progress                = 0;
-        this->_progressIsIndeterminate = false;
-        start                          = time( nullptr );
         
-        for( i = 0; i < n; i++ )
         {
-            password = *( passwords.begin() );
+            std::lock_guard< std::recursive_mutex > l( this->_rmtx );
             
-            if( password.length() > maxChars )
+            this->_message = "Preparing worker threads";
+        }
+        
+        delete this->_controller;
+        
+        this->_controller              = new ConcurrencyController( this->_maxThreads, this->_adaptiveThreads );
+        this->_filter                  = ( this->_deduplicationMemory > 0 && this->_markov == nullptr ) ? new DuplicateFilter( this->_deduplicationMemory ) : nullptr;
+        this->_numberOfPasswordsToTest = this->_source->count();
+        this->_processed               = 0;
+        this->_progress                = 0;
+        this->_lastProcessed           = 0;
+        this->_exhausted               = false;
+        this->_threadsRunning          = this->_controller->maxWorkers();
+        
+        this->_controller->logger
+        (
+            []( const std::string & message )
             {
-                variants = { password };
+                std::clog << "KeychainCracker: " << message << std::endl;
             }
-            else
+        );
+        
+        this->_source->tracer( this->_tracer );
+        this->_source->restart();
+        
+        for( i = 0; i < this->_controller->maxWorkers(); i++ )
+        {
+            try
             {
-                variants = ( this->*( func ) )( password );
+                this->_contexts.push_back( new VerifierContext( this->_keychainName ) );
             }
-            
-            this->_progress = static_cast< double >( i ) / static_cast< double >( n );
-            
-            snprintf( percent, sizeof(percent), "%.0f", this->_progress * 100 );
-            
-            this->_message  = message + " - " + percent + "%";
-            
-            passwords.erase( passwords.begin() );
-            passwords.insert( passwords.end(), variants.begin(), variants.end() );
-            
-            diff                    = static_cast< double >( time( nullptr ) - start );
-            this->_secondsRemaining = static_cast< unsigned long >( ( n - i ) / ( i / diff ) );
-            
-            if( this->_stopping )
+            catch( const std::exception & e )
             {
-                this->_progressIsIndeterminate = true;
+                std::clog << "KeychainCracker: " << e.what() << " - Worker " << i + 1 << " will use the shared keychain" << std::endl;
                 
-                return;
+                this->_contexts.push_back( nullptr );
             }
         }
         
-        this->_progressIsIndeterminate = true;
+        for( i = 0; i < this->_controller->maxWorkers(); i++ )
+        {
+            threads.push_back
+            (
+                std::thread
+                (
+                    [ this, i ]
+                    {
+                        this->crackSourceBatches( i );
+                    }
+                )
+            );
+        }
+        
+        this->_initialized             = true;
+        this->_progressIsIndeterminate = false;
+        
+        for( auto & t: threads )
+        {
+            t.join();
+        }
+        
+        for( auto context: this->_contexts )
+        {
+            delete context;
+        }
+        
+        this->_contexts.clear();
     }
     
-    void KeychainCracker::IMPL::crackPasswords( const std::list< std::string > & passwords )
+    void KeychainCracker::IMPL::crackSourceBatches( size_t worker )
     {
-        this->_threadsRunning++;
+        CandidateBatch      batch;
+        size_t              i;
+        bool                expand;
+        const Constraints * constraints;
+        VerifierContext   * context;
+        
+        expand      = this->_source == this->_stream && ( this->_maxCharsForCaseVariants > 0 || this->_maxCharsForCommonSubstitutions > 0 );
+        constraints = ( this->_source == this->_stream && this->_runConstraints.empty() == false ) ? &( this->_runConstraints ) : nullptr;
+        context     = this->_contexts[ worker ];
         
-        for( const auto & p: passwords )
+        if( this->_tracer != nullptr )
         {
-            if( this->_unlocked )
+            this->_tracer->threadName( "Worker " + std::to_string( worker + 1 ) );
+        }
+        
+        while( this->_unlocked == false && this->_stopping == false && this->_exhausted == false )
+        {
+            if( worker >= this->_controller->activeWorkers() )
             {
-                break;
+                TraceRecorder::Span span( this->_tracer, "parked" );
+                
+                this->_controller->waitUntilActive( worker, 100 );
+                
+                continue;
             }
             
-            if( this->_stopping )
             {
-                break;
+                TraceRecorder::Span span( this->_tracer, "dequeue" );
+                
+                if( this->_source->next( batch, KeychainCrackerBatchSize ) == false )
+                {
+                    this->_exhausted = true;
+                    
+                    break;
+                }
+                
+                span.count( batch.count() );
             }
             
-            this->_processed++;
+            TraceRecorder::Span span( this->_tracer, "verify batch", batch.count() );
             
-            if( SecKeychainUnlock( this->_keychain, static_cast< UInt32 >( p.length() ), p.c_str(), TRUE ) == noErr )
+            for( i = 0; i < batch.count(); i++ )
             {
+                if( this->_unlocked || this->_stopping )
                 {
-                    std::lock_guard< std::recursive_mutex > l( this->_rmtx );
-                    
-                    this->_foundPasswords.push_back( p );
-                    
-                    this->_unlocked = true;
-                    
                     break;
                 }
+                
+                if( expand == false )
+                {
+                    if( constraints == nullptr || constraints->accepts( batch.candidate( i ), batch.length( i ) ) )
+                    {
+                        this->tryPassword( batch.candidate( i ), batch.length( i ), context );
+                    }
+                    
+                    continue;
+                }
+                
+                for( const auto & p: ( constraints == nullptr ) ? PasswordVariants::expand( std::string( batch.candidate( i ), batch.length( i ) ), this->_maxCharsForCaseVariants, this->_maxCharsForCommonSubstitutions ) : PasswordVariants::expand( std::string( batch.candidate( i ), batch.length( i ) ), this->_maxCharsForCaseVariants, this->_maxCharsForCommonSubstitutions, *( constraints ) ) )
+                {
+                    if( this->_unlocked || this->_stopping || this->tryPassword( p.c_str(), p.length(), context ) )
+                    {
+                        break;
+                    }
+                }
             }
         }
         
         this->_threadsRunning--;
     }
     
+    bool KeychainCracker::IMPL::tryPassword( const char * password, size_t length, VerifierContext * context )
+    {
+        if( this->_filter != nullptr && this->_filter->insert( password, length ) == false )
+        {
+            return false;
+        }
+        
+        this->_processed++;
+        
+        if( this->unlock( password, length, context ) == false )
+        {
+            return false;
+        }
+        
+        {
+            std::lock_guard< std::recursive_mutex > l( this->_rmtx );
+            
+            this->_foundPasswords.push_back( std::string( password, length ) );
+            
+            this->_unlocked = true;
+        }
+        
+        return true;
+    }
+    
+    bool KeychainCracker::IMPL::unlock( const char * password, size_t length, VerifierContext * context )
+    {
+        if( context != nullptr )
+        {
+            return context->verify( password, length );
+        }
+        
+        if( this->_verifier != nullptr )
+        {
+            return this->_verifier->verify( password, length );
+        }
+        
+        return SecKeychainUnlock( this->_keychain, static_cast< UInt32 >( length ), password, TRUE ) == noErr;
+    }
+    
     void KeychainCracker::IMPL::checkProgress( void )
     {
         std::string validPassord;
         bool        found;
         
+        if( this->_tracer != nullptr )
+        {
+            this->_tracer->threadName( "Progress" );
+        }
+        
         while( 1 )
         {
             std::this_thread::sleep_for( std::chrono::seconds( 1 ) );
             
+            TraceRecorder::Span span( this->_tracer, "checkpoint" );
+            
             found = false;
             
             if( this->_stopping )
@@ -477,9 +1098,12 @@ namespace XS
                     
                     for( const auto & password: this->_foundPasswords )
                     {
-                        SecKeychainLock( this->_keychain );
+                        if( this->_keychain != nullptr )
+                        {
+                            SecKeychainLock( this->_keychain );
+                        }
                         
-                        if( SecKeychainUnlock( this->_keychain, static_cast< UInt32 >( password.length() ), password.c_str(), TRUE ) == noErr )
+                        if( this->unlock( password.c_str(), password.length(), nullptr ) )
                         {
                             found        = true;
                             validPassord = password;
@@ -495,13 +1119,48 @@ namespace XS
                 break;
             }
             
+            this->_controller->update( this->_processed );
+            
+            if( this->_filter != nullptr )
+            {
+                this->_duplicates = this->_filter->duplicates();
+            }
+            
+            if( this->_numberOfPasswordsToTest == 0 )
+            {
+                unsigned long done;
+                unsigned long last;
+                double        progress;
+                char          percent[ 4 ] = { 0, 0, 0, 0 };
+                
+                done            = this->_processed + this->_duplicates;
+                last            = ( this->_progress == 0 ) ? done : done - this->_lastProcessed;
+                progress        = std::min( this->_source->progress(), 1.0 );
+                
+                snprintf( percent, sizeof(percent), "%.0f", progress * 100 );
+                
+                this->_message          = std::string( "Trying " )
+                                        + std::to_string( done )
+                                        + " passwords from stream - "
+                                        + percent
+                                        + "% (~"
+                                        + std::to_string( last )
+                                        + " / sec"
+                                        + this->threadsDescription()
+                                        + this->duplicatesDescription()
+                                        + ")";
+                this->_secondsRemaining = ( last && progress > 0 ) ? static_cast< unsigned long >( ( static_cast< double >( done ) / progress - static_cast< double >( done ) ) / static_cast< double >( last ) ) : 0;
+                this->_progress         = progress;
+                this->_lastProcessed    = done;
+            }
+            else
             {
                 unsigned long done;
                 unsigned long last;
                 unsigned long total;
                 char          percent[ 4 ] = { 0, 0, 0, 0 };
                 
-                done            = this->_processed;
+                done            = this->_processed + this->_duplicates;
                 last            = ( this->_progress == 0 ) ? done : done - this->_lastProcessed;
                 total           = this->_numberOfPasswordsToTest;
                 this->_progress = static_cast< double >( done ) / static_cast< double >( total );
@@ -514,17 +1173,56 @@ namespace XS
                                         + percent
                                         + "% (~"
                                         + std::to_string( last )
-                                        + " / sec)";
+                                        + " / sec"
+                                        + this->threadsDescription()
+                                        + this->duplicatesDescription()
+                                        + ")";
                 this->_lastProcessed    = done;
                 this->_secondsRemaining = ( last ) ? ( total - done ) / last : 0;
             }
         }
         
+        this->_crackThread.join();
+        
         {
             std::lock_guard< std::recursive_mutex > l( this->_rmtx );
             
+            if( this->_filter != nullptr )
+            {
+                this->_duplicates = this->_filter->duplicates();
+                
+                std::clog << "KeychainCracker: "
+                          << this->_duplicates
+                          << " duplicate candidates skipped"
+                          << ( ( this->_filter->isApproximate() ) ? " (Bloom filter" : " (hash set" )
+                          << ", "
+                          << this->_filter->memoryUsage() / 1024
+                          << " KB"
+                          << ( ( this->_filter->approximateDuplicates() > 0 ) ? ", " + std::to_string( this->_filter->approximateDuplicates() ) + " of them rejected by the Bloom filter, which may include untested passwords" : "" )
+                          << ( ( this->_filter->unchecked() > 0 ) ? ", " + std::to_string( this->_filter->unchecked() ) + " unchecked after saturation" : "" )
+                          << ")"
+                          << std::endl;
+            }
+            
+            if( this->_tracer != nullptr )
+            {
+                if( this->_source != nullptr )
+                {
+                    this->_source->tracer( nullptr );
+                }
+                
+                if( this->_tracer->write( this->_traceFile ) == false )
+                {
+                    std::clog << "KeychainCracker: cannot write trace file " << this->_traceFile << std::endl;
+                }
+                else if( this->_tracer->dropped() > 0 )
+                {
+                    std::clog << "KeychainCracker: trace file " << this->_traceFile << " is missing the " << this->_tracer->dropped() << " oldest events, which were overwritten" << std::endl;
+                }
+            }
+            
             this->_running     = false;
-            this->_message     = "";
+            this->_message     = this->_error;
             this->_initialized = false;
             
             if( this->_completion != nullptr )
@@ -536,121 +1234,54 @@ namespace XS
         }
     }
     
-    std::list< std::string > KeychainCracker::IMPL::caseVariants( const std::string & str )
+    void KeychainCracker::IMPL::join( void )
     {
-        char                   * permutation;
-        const char             * cp;
-        size_t                   length;
-        size_t                   i;
-        size_t                   j;
-        size_t                   n;
-        std::list< std::string > variants;
-        
-        cp     = str.c_str();
-        length = str.length();
-        
-        if( length == 0 )
-        {
-            return {};
-        }
-        
-        permutation = new char[ length + 1 ];
-        
-        if( permutation == NULL )
-        {
-            return { str };
-        }
-        
-        for( i = 0, n = static_cast< size_t >( pow( 2, length ) ); i < n; i++ )
+        for( auto t: { &( this->_progressThread ), &( this->_crackThread ) } )
         {
-            for( j = 0; j < length; j++ )
+            if( t->joinable() == false )
             {
-                permutation[ j ] = ( ( i >> j & 1 ) != 0 ) ? static_cast< char >( toupper( cp[ j ] ) ) : cp[ j ];
+                continue;
             }
             
-            variants.push_back( permutation );
+            if( t->get_id() == std::this_thread::get_id() )
+            {
+                t->detach();
+            }
+            else
+            {
+                t->join();
+            }
         }
-        
-        delete[] permutation;
-        
-        return variants;
     }
     
-    static std::map< char, std::list< std::string > > * variants = nullptr;
-    
-    std::list< std::string > KeychainCracker::IMPL::commonSubstitutions( const std::string & str )
+    void KeychainCracker::IMPL::fail( const std::string & error )
     {
-        std::list< std::string > l;
-        char                     c;
+        std::lock_guard< std::recursive_mutex > l( this->_rmtx );
         
-        {
-            static std::once_flag once;
-            
-            std::call_once
-            (
-                once,
-                []
-                {
-                    variants = new std::map< char, std::list< std::string > >
-                    {
-                        { 'A', { "4", "@", "^", "Д" } },
-                        { 'B', { "8", "ß", "6" } },
-                        { 'C', { "[", "¢", "{", "<", "(", "©" } },
-                        { 'D', { ")", "?", ">" } },
-                        { 'E', { "3", "&", "£", "€", "ë" } },
-                        { 'F', { "ƒ", "v" } },
-                        { 'G', { "&", "6", "9", "{" } },
-                        { 'H', { "#" } },
-                        { 'I', { "1", "|", "!" } },
-                        { 'J', { ";", "1" } },
-                        { 'K', {} },
-                        { 'L', { "1", "£", "7", "|" } },
-                        { 'M', {} },
-                        { 'N', { "И", "^", "ท" } },
-                        { 'O', { "0", "Q", "p", "Ø" } },
-                        { 'P', { "9" } },
-                        { 'Q', { "9", "2", "&" } },
-                        { 'R', { "®", "Я" } },
-                        { 'S', { "5", "$", "z", "§", "2" } },
-                        { 'T', { "7", "+", "†" } },
-                        { 'U', { "v", "µ", "บ" } },
-                        { 'V', {} },
-                        { 'W', { "Ш", "Щ", "พ" } },
-                        { 'X', { "Ж", "×" } },
-                        { 'Y', { "j", "Ч", "7", "¥" } },
-                        { 'Z', { "2", "%", "s" } }
-                    };
-                    
-                    for( const auto & p: *( variants ) )
-                    {
-                        variants->insert( { tolower( p.first ), p.second } );
-                    }
-                }
-            );
-        }
+        std::clog << "KeychainCracker: " << error << std::endl;
         
-        if( str.length() == 0 )
+        this->_error = error;
+    }
+    
+    std::string KeychainCracker::IMPL::threadsDescription( void ) const
+    {
+        if( this->_adaptiveThreads == false )
         {
-            return { "" };
+            return "";
         }
         
-        c = str[ 0 ];
-        
-        for( const auto & tv: this->commonSubstitutions( str.substr( 1 ) ) )
+        return std::string( ", " )
+             + std::to_string( this->_controller->activeWorkers() )
+             + ( ( this->_controller->isSettled() ) ? " threads" : " threads, tuning" );
+    }
+    
+    std::string KeychainCracker::IMPL::duplicatesDescription( void ) const
+    {
+        if( this->_duplicates == 0 )
         {
-            l.push_back( c + tv );
-            
-            if( variants->count( c ) == 0 )
-            {
-                continue;
-            }
-            
-            for( const auto & v: variants->at( c ) )
-            {
-                l.push_back( v + tv );
-            }
+            return "";
         }
         
-        return l;
+        return std::string( ", " ) + std::to_string( this->_duplicates ) + " duplicates skipped";
     }
 }
@@ -30,6 +30,7 @@
 #ifndef XS_KEYCHAIN_CRACKER_HPP
 #define XS_KEYCHAIN_CRACKER_HPP
 
+#include "Constraints.hpp"
 #include <string>
 #include <list>
 #include <functional>
@@ -40,7 +41,15 @@ namespace XS
     {
         public:
             
+            enum HybridMode: unsigned int
+            {
+                HybridModeNone,
+                HybridModeAppend,
+                HybridModePrepend
+            };
+            
             KeychainCracker( const std::string & keychain, const std::list< std::string > & passwords );
+            KeychainCracker( const std::string & keychain, const std::string & wordList );
             ~KeychainCracker( void );
             
             KeychainCracker( const KeychainCracker & o )      = delete;
@@ -50,17 +59,41 @@ namespace XS
             friend void swap( KeychainCracker & o1, KeychainCracker & o2 );
             
             std::string   message( void )                 const;
+            std::string   error( void )                   const;
             double        progress( void )                const;
             bool          progressIsIndeterminate( void ) const;
             unsigned long secondsRemaining( void )        const;
+            unsigned long candidatesTried( void )         const;
             
             void crack( const std::function< void( bool, const std::string & ) > & completion );
             void stop( void );
             
+            std::string traceFile( void ) const;
+            void        traceFile( const std::string & path );
+            
+            HybridMode  hybridMode( void ) const;
+            std::string hybridMask( void ) const;
+            void        hybridMask( const std::string & mask, HybridMode mode );
+            
+            size_t       markovMinLength( void ) const;
+            size_t       markovMaxLength( void ) const;
+            unsigned int markovThreshold( void ) const;
+            void         markovLength( size_t minLength, size_t maxLength );
+            void         markovThreshold( unsigned int value );
+            
+            Constraints constraints( void ) const;
+            void        constraints( const Constraints & value );
+            
+            size_t        deduplicationMemory( void ) const;
+            unsigned long duplicatesSkipped( void )   const;
+            void          deduplicationMemory( size_t bytes );
+            
+            bool   adaptiveThreads( void )                const;
             size_t maxThreads( void )                     const;
             size_t maxCharsForCaseVariants( void )        const;
             size_t maxCharsForCommonSubstitutions( void ) const;
             
+            void adaptiveThreads( bool value );
             void maxThreads( size_t value );
             void maxCharsForCaseVariants( size_t value );
             void maxCharsForCommonSubstitutions( size_t value );
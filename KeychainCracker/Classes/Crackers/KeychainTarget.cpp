@@ -0,0 +1,405 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        KeychainTarget.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "KeychainTarget.hpp"
+#include <stdexcept>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <cstring>
+#include <zlib.h>
+#include <CommonCrypto/CommonCrypto.h>
+
+namespace XS
+{
+    static const char     KeychainTargetMagic[ 4 ]       = { 'K', 'C', 'T', 'D' };
+    static const uint32_t KeychainTargetVersion          = 2;
+    static const char     KeychainTargetFileMagic[ 4 ]   = { 'k', 'y', 'c', 'h' };
+    static const uint8_t  KeychainTargetDbBlobMagic[ 4 ] = { 0xFA, 0xDE, 0x07, 0x11 };
+    static const uint32_t KeychainTargetDbBlobVersion    = 0x100;
+    static const uint32_t KeychainTargetIdleTimeout      = 300;
+    static const uint32_t KeychainTargetIterations       = 1000;
+    static const size_t   KeychainTargetParamsOffset     = 36;
+    static const size_t   KeychainTargetSaltOffset       = 44;
+    static const size_t   KeychainTargetIVOffset         = 64;
+    static const size_t   KeychainTargetSignatureOffset  = 72;
+    static const size_t   KeychainTargetBlobHeader       = 92;
+    static const size_t   KeychainTargetMasterKeyLength  = 44;
+    
+    struct KeychainTargetHeader
+    {
+        char     magic[ 4 ];
+        uint32_t version;
+        uint32_t iterations;
+        uint32_t blobLength;
+        uint32_t headerLength;
+        uint8_t  salt[ KeychainTarget::SaltLength ];
+        uint8_t  iv[ KeychainTarget::IVLength ];
+        uint8_t  signature[ CC_SHA1_DIGEST_LENGTH ];
+        uint32_t checksum;
+    };
+    
+    const size_t KeychainTarget::SaltLength;
+    const size_t KeychainTarget::IVLength;
+    
+    static uint32_t               KeychainTargetReadBigEndian( const std::string & data, size_t offset );
+    static void                   KeychainTargetWriteBigEndian( std::vector< uint8_t > & data, size_t offset, uint32_t value );
+    static std::vector< uint8_t > KeychainTargetSign( const std::vector< uint8_t > & header, const std::vector< uint8_t > & blob, const uint8_t * key, size_t length );
+    static uint32_t               KeychainTargetChecksum( KeychainTargetHeader header, const std::vector< uint8_t > & signedHeader, const std::vector< uint8_t > & blob );
+    
+    class KeychainTarget::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & path );
+            IMPL( const std::string & password, const std::vector< uint8_t > & salt, const std::vector< uint8_t > & iv, uint32_t iterations );
+            
+            void readDescriptor( const std::string & data, const std::string & path );
+            void readKeychain( const std::string & data, const std::string & path );
+            
+            uint32_t               _iterations;
+            std::vector< uint8_t > _salt;
+            std::vector< uint8_t > _iv;
+            std::vector< uint8_t > _blob;
+            std::vector< uint8_t > _header;
+            std::vector< uint8_t > _signature;
+    };
+    
+    KeychainTarget::KeychainTarget( const std::string & path ):
+        impl( new IMPL( path ) )
+    {}
+    
+    KeychainTarget::KeychainTarget( const std::string & password, const std::vector< uint8_t > & salt, const std::vector< uint8_t > & iv, uint32_t iterations ):
+        impl( new IMPL( password, salt, iv, iterations ) )
+    {}
+    
+    KeychainTarget::~KeychainTarget( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( KeychainTarget & o1, KeychainTarget & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    bool KeychainTarget::isTarget( const std::string & path )
+    {
+        std::ifstream in( path, std::ios::binary );
+        char          magic[ 4 ] = { 0, 0, 0, 0 };
+        
+        if( in.good() == false )
+        {
+            return false;
+        }
+        
+        in.read( magic, sizeof( magic ) );
+        
+        return in.good() && memcmp( magic, KeychainTargetMagic, sizeof( magic ) ) == 0;
+    }
+    
+    uint32_t KeychainTarget::iterations( void ) const
+    {
+        return this->impl->_iterations;
+    }
+    
+    const std::vector< uint8_t > & KeychainTarget::salt( void ) const
+    {
+        return this->impl->_salt;
+    }
+    
+    const std::vector< uint8_t > & KeychainTarget::iv( void ) const
+    {
+        return this->impl->_iv;
+    }
+    
+    const std::vector< uint8_t > & KeychainTarget::blob( void ) const
+    {
+        return this->impl->_blob;
+    }
+    
+    const std::vector< uint8_t > & KeychainTarget::header( void ) const
+    {
+        return this->impl->_header;
+    }
+    
+    const std::vector< uint8_t > & KeychainTarget::signature( void ) const
+    {
+        return this->impl->_signature;
+    }
+    
+    std::vector< uint8_t > KeychainTarget::sign( const uint8_t * key, size_t length ) const
+    {
+        return KeychainTargetSign( this->impl->_header, this->impl->_blob, key, length );
+    }
+    
+    void KeychainTarget::write( const std::string & path ) const
+    {
+        std::ofstream        out;
+        KeychainTargetHeader header;
+        
+        memset( &header, 0, sizeof( header ) );
+        memcpy( header.magic,     KeychainTargetMagic,           sizeof( header.magic ) );
+        memcpy( header.salt,      this->impl->_salt.data(),      sizeof( header.salt ) );
+        memcpy( header.iv,        this->impl->_iv.data(),        sizeof( header.iv ) );
+        memcpy( header.signature, this->impl->_signature.data(), sizeof( header.signature ) );
+        
+        header.version      = KeychainTargetVersion;
+        header.iterations   = this->impl->_iterations;
+        header.blobLength   = static_cast< uint32_t >( this->impl->_blob.size() );
+        header.headerLength = static_cast< uint32_t >( this->impl->_header.size() );
+        header.checksum     = KeychainTargetChecksum( header, this->impl->_header, this->impl->_blob );
+        
+        out.open( path, std::ios::binary | std::ios::trunc );
+        
+        if( out.good() == false )
+        {
+            throw std::runtime_error( std::string( "Cannot create target descriptor " ) + path );
+        }
+        
+        out.write( reinterpret_cast< const char * >( &header ), sizeof( header ) );
+        out.write( reinterpret_cast< const char * >( this->impl->_header.data() ), static_cast< std::streamsize >( this->impl->_header.size() ) );
+        out.write( reinterpret_cast< const char * >( this->impl->_blob.data() ), static_cast< std::streamsize >( this->impl->_blob.size() ) );
+        out.close();
+        
+        if( out.fail() )
+        {
+            throw std::runtime_error( std::string( "Error writing target descriptor " ) + path );
+        }
+    }
+    
+    KeychainTarget::IMPL::IMPL( const std::string & path ):
+        _iterations( 0 )
+    {
+        std::ifstream in( path, std::ios::binary );
+        std::string   data;
+        
+        if( in.good() == false )
+        {
+            throw std::runtime_error( std::string( "Cannot open keychain " ) + path );
+        }
+        
+        data.assign( std::istreambuf_iterator< char >( in ), std::istreambuf_iterator< char >() );
+        
+        if( data.size() >= sizeof( KeychainTargetMagic ) && memcmp( data.data(), KeychainTargetMagic, sizeof( KeychainTargetMagic ) ) == 0 )
+        {
+            this->readDescriptor( data, path );
+        }
+        else if( data.size() >= sizeof( KeychainTargetFileMagic ) && memcmp( data.data(), KeychainTargetFileMagic, sizeof( KeychainTargetFileMagic ) ) == 0 )
+        {
+            this->readKeychain( data, path );
+        }
+        else
+        {
+            throw std::runtime_error( std::string( "Not a keychain or target descriptor: " ) + path );
+        }
+    }
+    
+    KeychainTarget::IMPL::IMPL( const std::string & password, const std::vector< uint8_t > & salt, const std::vector< uint8_t > & iv, uint32_t iterations ):
+        _iterations( iterations ),
+        _salt(       salt ),
+        _iv(         iv ),
+        _blob(       KeychainTargetMasterKeyLength + kCCBlockSize3DES )
+    {
+        std::seed_seq          seed( salt.begin(), salt.end() );
+        std::mt19937           random( seed );
+        std::vector< uint8_t > masterKey;
+        uint8_t                key[ kCCKeySize3DES ];
+        size_t                 moved;
+        size_t                 i;
+        
+        if( salt.size() != KeychainTarget::SaltLength || iv.size() != KeychainTarget::IVLength || iterations == 0 )
+        {
+            throw std::runtime_error( "Invalid target parameters" );
+        }
+        
+        for( auto b: iv )
+        {
+            random.discard( b );
+        }
+        
+        while( masterKey.size() < KeychainTargetMasterKeyLength )
+        {
+            masterKey.push_back( static_cast< uint8_t >( random() ) );
+        }
+        
+        if( CCKeyDerivationPBKDF( kCCPBKDF2, password.data(), password.length(), salt.data(), salt.size(), kCCPRFHmacAlgSHA1, iterations, key, sizeof( key ) ) != 0 )
+        {
+            throw std::runtime_error( "Cannot derive key" );
+        }
+        
+        if( CCCrypt( kCCEncrypt, kCCAlgorithm3DES, kCCOptionPKCS7Padding, key, sizeof( key ), iv.data(), masterKey.data(), masterKey.size(), this->_blob.data(), this->_blob.size(), &moved ) != kCCSuccess )
+        {
+            throw std::runtime_error( "Cannot wrap master key" );
+        }
+        
+        this->_blob.resize( moved );
+        this->_header.resize( KeychainTargetSignatureOffset );
+        
+        memcpy( this->_header.data(), KeychainTargetDbBlobMagic, sizeof( KeychainTargetDbBlobMagic ) );
+        KeychainTargetWriteBigEndian( this->_header, 4,  KeychainTargetDbBlobVersion );
+        KeychainTargetWriteBigEndian( this->_header, 8,  static_cast< uint32_t >( KeychainTargetBlobHeader ) );
+        KeychainTargetWriteBigEndian( this->_header, 12, static_cast< uint32_t >( KeychainTargetBlobHeader + moved ) );
+        
+        for( i = 16; i < KeychainTargetParamsOffset - 4; i++ )
+        {
+            this->_header[ i ] = static_cast< uint8_t >( random() );
+        }
+        
+        KeychainTargetWriteBigEndian( this->_header, KeychainTargetParamsOffset, KeychainTargetIdleTimeout );
+        
+        this->_header[ KeychainTargetParamsOffset + 4 ] = 1;
+        
+        memcpy( this->_header.data() + KeychainTargetSaltOffset, salt.data(), salt.size() );
+        memcpy( this->_header.data() + KeychainTargetIVOffset,   iv.data(),   iv.size() );
+        
+        this->_signature = KeychainTargetSign( this->_header, this->_blob, masterKey.data() + kCCKeySize3DES, KeychainTargetMasterKeyLength - kCCKeySize3DES );
+    }
+    
+    void KeychainTarget::IMPL::readDescriptor( const std::string & data, const std::string & path )
+    {
+        KeychainTargetHeader header;
+        
+        if( data.size() < sizeof( header ) )
+        {
+            throw std::runtime_error( std::string( "Invalid target descriptor " ) + path );
+        }
+        
+        memcpy( &header, data.data(), sizeof( header ) );
+        
+        if( header.version != KeychainTargetVersion )
+        {
+            throw std::runtime_error( std::string( "Unsupported target descriptor version in " ) + path );
+        }
+        
+        if( header.blobLength == 0 || header.blobLength % 8 != 0 || header.headerLength < KeychainTargetSignatureOffset || data.size() != sizeof( header ) + header.headerLength + header.blobLength || header.iterations == 0 )
+        {
+            throw std::runtime_error( std::string( "Invalid target descriptor " ) + path );
+        }
+        
+        this->_iterations = header.iterations;
+        
+        this->_salt.assign( header.salt, header.salt + sizeof( header.salt ) );
+        this->_iv.assign( header.iv, header.iv + sizeof( header.iv ) );
+        this->_signature.assign( header.signature, header.signature + sizeof( header.signature ) );
+        this->_header.assign( data.begin() + sizeof( header ), data.begin() + static_cast< std::ptrdiff_t >( sizeof( header ) + header.headerLength ) );
+        this->_blob.assign( data.begin() + static_cast< std::ptrdiff_t >( sizeof( header ) + header.headerLength ), data.end() );
+        
+        if( KeychainTargetChecksum( header, this->_header, this->_blob ) != header.checksum )
+        {
+            throw std::runtime_error( std::string( "Corrupted target descriptor " ) + path );
+        }
+    }
+    
+    void KeychainTarget::IMPL::readKeychain( const std::string & data, const std::string & path )
+    {
+        std::string magic( reinterpret_cast< const char * >( KeychainTargetDbBlobMagic ), sizeof( KeychainTargetDbBlobMagic ) );
+        size_t      offset;
+        size_t      start;
+        size_t      end;
+        
+        for( offset = data.find( magic ); offset != std::string::npos; offset = data.find( magic, offset + 1 ) )
+        {
+            if( offset + KeychainTargetBlobHeader > data.size() )
+            {
+                break;
+            }
+            
+            start = KeychainTargetReadBigEndian( data, offset + 8 );
+            end   = KeychainTargetReadBigEndian( data, offset + 12 );
+            
+            if( start < KeychainTargetBlobHeader || end <= start || ( end - start ) % 8 != 0 || offset + end > data.size() )
+            {
+                continue;
+            }
+            
+            this->_iterations = KeychainTargetIterations;
+            
+            this->_salt.assign( data.begin() + static_cast< std::ptrdiff_t >( offset + KeychainTargetSaltOffset ), data.begin() + static_cast< std::ptrdiff_t >( offset + KeychainTargetIVOffset ) );
+            this->_iv.assign( data.begin() + static_cast< std::ptrdiff_t >( offset + KeychainTargetIVOffset ), data.begin() + static_cast< std::ptrdiff_t >( offset + KeychainTargetIVOffset + 8 ) );
+            this->_blob.assign( data.begin() + static_cast< std::ptrdiff_t >( offset + start ), data.begin() + static_cast< std::ptrdiff_t >( offset + end ) );
+            this->_header.assign( data.begin() + static_cast< std::ptrdiff_t >( offset ), data.begin() + static_cast< std::ptrdiff_t >( offset + KeychainTargetSignatureOffset ) );
+            this->_header.insert( this->_header.end(), data.begin() + static_cast< std::ptrdiff_t >( offset + KeychainTargetBlobHeader ), data.begin() + static_cast< std::ptrdiff_t >( offset + start ) );
+            this->_signature.assign( data.begin() + static_cast< std::ptrdiff_t >( offset + KeychainTargetSignatureOffset ), data.begin() + static_cast< std::ptrdiff_t >( offset + KeychainTargetBlobHeader ) );
+            
+            return;
+        }
+        
+        throw std::runtime_error( std::string( "No database blob found in keychain " ) + path );
+    }
+    
+    static uint32_t KeychainTargetReadBigEndian( const std::string & data, size_t offset )
+    {
+        const unsigned char * p;
+        
+        p = reinterpret_cast< const unsigned char * >( data.data() ) + offset;
+        
+        return ( static_cast< uint32_t >( p[ 0 ] ) << 24 )
+             | ( static_cast< uint32_t >( p[ 1 ] ) << 16 )
+             | ( static_cast< uint32_t >( p[ 2 ] ) << 8 )
+             |   static_cast< uint32_t >( p[ 3 ] );
+    }
+    
+    static void KeychainTargetWriteBigEndian( std::vector< uint8_t > & data, size_t offset, uint32_t value )
+    {
+        data[ offset ]     = static_cast< uint8_t >( value >> 24 );
+        data[ offset + 1 ] = static_cast< uint8_t >( value >> 16 );
+        data[ offset + 2 ] = static_cast< uint8_t >( value >> 8 );
+        data[ offset + 3 ] = static_cast< uint8_t >( value );
+    }
+    
+    static std::vector< uint8_t > KeychainTargetSign( const std::vector< uint8_t > & header, const std::vector< uint8_t > & blob, const uint8_t * key, size_t length )
+    {
+        CCHmacContext          context;
+        std::vector< uint8_t > signature( CC_SHA1_DIGEST_LENGTH );
+        
+        CCHmacInit( &context, kCCHmacAlgSHA1, key, length );
+        CCHmacUpdate( &context, header.data(), header.size() );
+        CCHmacUpdate( &context, blob.data(), blob.size() );
+        CCHmacFinal( &context, signature.data() );
+        
+        return signature;
+    }
+    
+    static uint32_t KeychainTargetChecksum( KeychainTargetHeader header, const std::vector< uint8_t > & signedHeader, const std::vector< uint8_t > & blob )
+    {
+        uLong crc;
+        
+        header.checksum = 0;
+        crc             = crc32( 0, Z_NULL, 0 );
+        crc             = crc32( crc, reinterpret_cast< const Bytef * >( &header ), sizeof( header ) );
+        crc             = crc32( crc, signedHeader.data(), static_cast< uInt >( signedHeader.size() ) );
+        crc             = crc32( crc, blob.data(), static_cast< uInt >( blob.size() ) );
+        
+        return static_cast< uint32_t >( crc );
+    }
+}
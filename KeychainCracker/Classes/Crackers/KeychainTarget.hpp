@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      KeychainTarget.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_KEYCHAIN_TARGET_HPP
+#define XS_KEYCHAIN_TARGET_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace XS
+{
+    /*!
+     * What is needed to test a password against a keychain, and nothing else:
+     * the salt, IV and wrapped master key of the keychain's database blob,
+     * along with the key derivation iteration count.
+     * 
+     * The signing key unwrapped with the master key authenticates the
+     * database blob: header() is what the blob's signature() covers besides
+     * the wrapped key (the fixed header up to the signature, then the public
+     * ACL), and sign() computes the HMAC-SHA1 of that header followed by the
+     * wrapped key.
+     * 
+     * A target can be read from a keychain-db file, or from the small
+     * descriptor written by KeychainTarget::write. A descriptor is a
+     * fixed-size header followed by the signed header and the wrapped key,
+     * protected by a CRC-32,
+     * so it loads instantly and can be copied to other machines without the
+     * original keychain.
+     * 
+     * A target can also be created for a known password, to build test and
+     * benchmark fixtures. The master key is then wrapped exactly like in a
+     * keychain, and derived from the salt and IV so that the same parameters
+     * always give the same descriptor.
+     */
+    class KeychainTarget
+    {
+        public:
+            
+            explicit KeychainTarget( const std::string & path );
+            KeychainTarget( const std::string & password, const std::vector< uint8_t > & salt, const std::vector< uint8_t > & iv, uint32_t iterations );
+            ~KeychainTarget( void );
+            
+            KeychainTarget( const KeychainTarget & o )      = delete;
+            KeychainTarget( KeychainTarget && o )           = delete;
+            KeychainTarget & operator =( KeychainTarget o ) = delete;
+            
+            friend void swap( KeychainTarget & o1, KeychainTarget & o2 );
+            
+            static const size_t SaltLength = 20;
+            static const size_t IVLength   = 8;
+            
+            static bool isTarget( const std::string & path );
+            
+            uint32_t                       iterations( void ) const;
+            const std::vector< uint8_t > & salt( void )       const;
+            const std::vector< uint8_t > & iv( void )         const;
+            const std::vector< uint8_t > & blob( void )       const;
+            const std::vector< uint8_t > & header( void )     const;
+            const std::vector< uint8_t > & signature( void )  const;
+            
+            std::vector< uint8_t > sign( const uint8_t * key, size_t length ) const;
+            
+            void write( const std::string & path ) const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_KEYCHAIN_TARGET_HPP */
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        KeychainVerifier.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "KeychainVerifier.hpp"
+#include "KeychainTarget.hpp"
+#include <stdexcept>
+#include <vector>
+#include <cstdint>
+#include <CommonCrypto/CommonCrypto.h>
+
+namespace XS
+{
+    static const size_t  KeychainVerifierPlainLength = 44;
+    static const uint8_t KeychainVerifierPadding     = kCCBlockSize3DES - KeychainVerifierPlainLength % kCCBlockSize3DES;
+    
+    class KeychainVerifier::IMPL
+    {
+        public:
+            
+            IMPL( const KeychainTarget & target );
+            
+            bool authenticate( const uint8_t * key ) const;
+            
+            const KeychainTarget & _target;
+            const uint8_t        * _lastBlock;
+            const uint8_t        * _lastIV;
+    };
+    
+    KeychainVerifier::KeychainVerifier( const KeychainTarget & target ):
+        impl( new IMPL( target ) )
+    {}
+    
+    KeychainVerifier::~KeychainVerifier( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( KeychainVerifier & o1, KeychainVerifier & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    bool KeychainVerifier::verify( const char * password, size_t length ) const
+    {
+        uint8_t key[ kCCKeySize3DES ];
+        uint8_t block[ kCCBlockSize3DES ];
+        size_t  moved;
+        size_t  i;
+        
+        if
+        (
+            CCKeyDerivationPBKDF
+            (
+                kCCPBKDF2,
+                password,
+                length,
+                this->impl->_target.salt().data(),
+                this->impl->_target.salt().size(),
+                kCCPRFHmacAlgSHA1,
+                this->impl->_target.iterations(),
+                key,
+                sizeof( key )
+            )
+            != 0
+        )
+        {
+            return false;
+        }
+        
+        if( CCCrypt( kCCDecrypt, kCCAlgorithm3DES, 0, key, sizeof( key ), this->impl->_lastIV, this->impl->_lastBlock, sizeof( block ), block, sizeof( block ), &moved ) != kCCSuccess || moved != sizeof( block ) )
+        {
+            return false;
+        }
+        
+        for( i = sizeof( block ) - KeychainVerifierPadding; i < sizeof( block ); i++ )
+        {
+            if( block[ i ] != KeychainVerifierPadding )
+            {
+                return false;
+            }
+        }
+        
+        return this->impl->authenticate( key );
+    }
+    
+    KeychainVerifier::IMPL::IMPL( const KeychainTarget & target ):
+        _target( target )
+    {
+        const std::vector< uint8_t > & blob = target.blob();
+        
+        if( blob.size() < KeychainVerifierPlainLength + KeychainVerifierPadding || blob.size() % kCCBlockSize3DES != 0 || target.iv().size() != kCCBlockSize3DES )
+        {
+            throw std::runtime_error( "Unsupported keychain target" );
+        }
+        
+        this->_lastBlock = blob.data() + blob.size() - kCCBlockSize3DES;
+        this->_lastIV    = ( blob.size() > kCCBlockSize3DES ) ? this->_lastBlock - kCCBlockSize3DES : target.iv().data();
+    }
+    
+    bool KeychainVerifier::IMPL::authenticate( const uint8_t * key ) const
+    {
+        const std::vector< uint8_t > & blob = this->_target.blob();
+        std::vector< uint8_t >         plain( blob.size() );
+        size_t                         moved;
+        
+        if( CCCrypt( kCCDecrypt, kCCAlgorithm3DES, 0, key, kCCKeySize3DES, this->_target.iv().data(), blob.data(), blob.size(), plain.data(), plain.size(), &moved ) != kCCSuccess || moved != blob.size() )
+        {
+            return false;
+        }
+        
+        return this->_target.sign( plain.data() + kCCKeySize3DES, KeychainVerifierPlainLength - kCCKeySize3DES ) == this->_target.signature();
+    }
+}
@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      KeychainVerifier.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_KEYCHAIN_VERIFIER_HPP
+#define XS_KEYCHAIN_VERIFIER_HPP
+
+#include <cstddef>
+
+namespace XS
+{
+    class KeychainTarget;
+    
+    /*!
+     * Tests passwords against a KeychainTarget without going through the
+     * Security framework: the key is derived with PBKDF2-HMAC-SHA1, then
+     * used to unwrap the master key with 3DES-CBC. A password is a candidate
+     * when the last block of the unwrapped blob ends with valid padding,
+     * which happens by chance about once in 2^32 wrong passwords, so it is
+     * only reported as correct when the signing key found in the blob also
+     * verifies the signature of the database blob.
+     * 
+     * verify() does not modify the verifier, and can be called from any
+     * number of threads. The target must outlive the verifier.
+     */
+    class KeychainVerifier
+    {
+        public:
+            
+            explicit KeychainVerifier( const KeychainTarget & target );
+            ~KeychainVerifier( void );
+            
+            KeychainVerifier( const KeychainVerifier & o )      = delete;
+            KeychainVerifier( KeychainVerifier && o )           = delete;
+            KeychainVerifier & operator =( KeychainVerifier o ) = delete;
+            
+            friend void swap( KeychainVerifier & o1, KeychainVerifier & o2 );
+            
+            bool verify( const char * password, size_t length ) const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_KEYCHAIN_VERIFIER_HPP */
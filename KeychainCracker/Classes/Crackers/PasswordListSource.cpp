@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        PasswordListSource.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "PasswordListSource.hpp"
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+namespace XS
+{
+    class PasswordListSource::IMPL
+    {
+        public:
+            
+            IMPL( const std::list< std::string > & passwords );
+            
+            std::vector< std::string > _passwords;
+            std::atomic< size_t >      _cursor;
+    };
+    
+    PasswordListSource::PasswordListSource( const std::list< std::string > & passwords ):
+        impl( new IMPL( passwords ) )
+    {}
+    
+    PasswordListSource::~PasswordListSource( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( PasswordListSource & o1, PasswordListSource & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    void PasswordListSource::restart( void )
+    {
+        this->impl->_cursor = 0;
+    }
+    
+    bool PasswordListSource::next( CandidateBatch & batch, size_t max )
+    {
+        size_t begin;
+        size_t end;
+        size_t i;
+        
+        batch.clear();
+        
+        begin = this->impl->_cursor.fetch_add( max );
+        end   = std::min( begin + max, this->impl->_passwords.size() );
+        
+        for( i = begin; i < end; i++ )
+        {
+            batch.addReference( this->impl->_passwords[ i ].data(), this->impl->_passwords[ i ].length() );
+        }
+        
+        return batch.count() > 0;
+    }
+    
+    size_t PasswordListSource::count( void ) const
+    {
+        return this->impl->_passwords.size();
+    }
+    
+    double PasswordListSource::progress( void ) const
+    {
+        if( this->impl->_passwords.size() == 0 )
+        {
+            return 1.0;
+        }
+        
+        return std::min( static_cast< double >( this->impl->_cursor ) / static_cast< double >( this->impl->_passwords.size() ), 1.0 );
+    }
+    
+    PasswordListSource::IMPL::IMPL( const std::list< std::string > & passwords ):
+        _passwords( passwords.begin(), passwords.end() ),
+        _cursor(    0 )
+    {}
+}
@@ -0,0 +1,418 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        PasswordVariants.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "PasswordVariants.hpp"
+#include "Constraints.hpp"
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <cmath>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+#include <iterator>
+
+namespace XS
+{
+    static const std::map< char, std::list< std::string > > & PasswordVariantsSubstitutions( void );
+    static std::list< std::string > PasswordVariantsConstrained( const std::string & str, bool caseVariants, bool substitutions, const Constraints & constraints );
+    static void PasswordVariantsVisit( const std::vector< std::vector< std::string > > & options, const std::vector< unsigned int > & available, const Constraints & constraints, size_t position, unsigned int found, std::string & candidate, std::list< std::string > & results );
+    
+    std::list< std::string > PasswordVariants::expand( const std::string & str, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions )
+    {
+        std::list< std::string > passwords;
+        std::list< std::string > substitutions;
+        
+        if( maxCharsForCaseVariants > 0 && str.length() <= maxCharsForCaseVariants )
+        {
+            passwords = PasswordVariants::caseVariants( str );
+        }
+        else
+        {
+            passwords = { str };
+        }
+        
+        if( maxCharsForCommonSubstitutions == 0 || str.length() > maxCharsForCommonSubstitutions )
+        {
+            return passwords;
+        }
+        
+        for( const auto & p: passwords )
+        {
+            substitutions.splice( substitutions.end(), PasswordVariants::commonSubstitutions( p ) );
+        }
+        
+        return substitutions;
+    }
+    
+    std::list< std::string > PasswordVariants::caseVariants( const std::string & str )
+    {
+        char                   * permutation;
+        const char             * cp;
+        size_t                   length;
+        size_t                   i;
+        size_t                   j;
+        size_t                   n;
+        std::list< std::string > variants;
+        
+        cp     = str.c_str();
+        length = str.length();
+        
+        if( length == 0 )
+        {
+            return {};
+        }
+        
+        permutation = new char[ length + 1 ];
+        
+        if( permutation == NULL )
+        {
+            return { str };
+        }
+        
+        permutation[ length ] = 0;
+        
+        for( i = 0, n = static_cast< size_t >( pow( 2, length ) ); i < n; i++ )
+        {
+            for( j = 0; j < length; j++ )
+            {
+                permutation[ j ] = ( ( i >> j & 1 ) != 0 ) ? static_cast< char >( toupper( cp[ j ] ) ) : cp[ j ];
+            }
+            
+            variants.push_back( permutation );
+        }
+        
+        delete[] permutation;
+        
+        return variants;
+    }
+    
+    static std::map< char, std::list< std::string > > * variants = nullptr;
+    
+    static const std::map< char, std::list< std::string > > & PasswordVariantsSubstitutions( void )
+    {
+        static std::once_flag once;
+        
+        std::call_once
+        (
+            once,
+            []
+            {
+                variants = new std::map< char, std::list< std::string > >
+                {
+                    { 'A', { "4", "@", "^", "Д" } },
+                    { 'B', { "8", "ß", "6" } },
+                    { 'C', { "[", "¢", "{", "<", "(", "©" } },
+                    { 'D', { ")", "?", ">" } },
+                    { 'E', { "3", "&", "£", "€", "ë" } },
+                    { 'F', { "ƒ", "v" } },
+                    { 'G', { "&", "6", "9", "{" } },
+                    { 'H', { "#" } },
+                    { 'I', { "1", "|", "!" } },
+                    { 'J', { ";", "1" } },
+                    { 'K', {} },
+                    { 'L', { "1", "£", "7", "|" } },
+                    { 'M', {} },
+                    { 'N', { "И", "^", "ท" } },
+                    { 'O', { "0", "Q", "p", "Ø" } },
+                    { 'P', { "9" } },
+                    { 'Q', { "9", "2", "&" } },
+                    { 'R', { "®", "Я" } },
+                    { 'S', { "5", "$", "z", "§", "2" } },
+                    { 'T', { "7", "+", "†" } },
+                    { 'U', { "v", "µ", "บ" } },
+                    { 'V', {} },
+                    { 'W', { "Ш", "Щ", "พ" } },
+                    { 'X', { "Ж", "×" } },
+                    { 'Y', { "j", "Ч", "7", "¥" } },
+                    { 'Z', { "2", "%", "s" } }
+                };
+                
+                for( const auto & p: *( variants ) )
+                {
+                    variants->insert( { tolower( p.first ), p.second } );
+                }
+            }
+        );
+        
+        return *( variants );
+    }
+    
+    std::list< std::string > PasswordVariants::commonSubstitutions( const std::string & str )
+    {
+        const std::map< char, std::list< std::string > > & table = PasswordVariantsSubstitutions();
+        std::list< std::string >                           l;
+        char                                               c;
+        
+        if( str.length() == 0 )
+        {
+            return { "" };
+        }
+        
+        c = str[ 0 ];
+        
+        for( const auto & tv: PasswordVariants::commonSubstitutions( str.substr( 1 ) ) )
+        {
+            l.push_back( c + tv );
+            
+            if( table.count( c ) == 0 )
+            {
+                continue;
+            }
+            
+            for( const auto & v: table.at( c ) )
+            {
+                l.push_back( v + tv );
+            }
+        }
+        
+        return l;
+    }
+    
+    uint64_t PasswordVariants::count( const char * str, size_t length, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions )
+    {
+        const std::map< char, std::list< std::string > > & table = PasswordVariantsSubstitutions();
+        uint64_t                                           n;
+        uint64_t                                           radix;
+        size_t                                             i;
+        
+        n = 1;
+        
+        if( maxCharsForCaseVariants > 0 && length <= maxCharsForCaseVariants )
+        {
+            if( length >= std::numeric_limits< uint64_t >::digits )
+            {
+                throw std::runtime_error( "Too many case variants" );
+            }
+            
+            n = ( length == 0 ) ? 0 : static_cast< uint64_t >( 1 ) << length;
+        }
+        
+        if( maxCharsForCommonSubstitutions == 0 || length > maxCharsForCommonSubstitutions )
+        {
+            return n;
+        }
+        
+        for( i = 0; i < length; i++ )
+        {
+            radix = ( table.count( str[ i ] ) == 0 ) ? 1 : table.at( str[ i ] ).size() + 1;
+            
+            if( n > std::numeric_limits< uint64_t >::max() / radix )
+            {
+                throw std::runtime_error( "Too many common substitutions" );
+            }
+            
+            n *= radix;
+        }
+        
+        return n;
+    }
+    
+    void PasswordVariants::variant( const char * str, size_t length, uint64_t index, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions, std::string & variant )
+    {
+        const std::map< char, std::list< std::string > > & table = PasswordVariantsSubstitutions();
+        uint64_t                                           mask;
+        uint64_t                                           choices;
+        uint64_t                                           radix;
+        uint64_t                                           choice;
+        size_t                                             i;
+        bool                                               substitutions;
+        char                                               c;
+        
+        substitutions = maxCharsForCommonSubstitutions > 0 && length <= maxCharsForCommonSubstitutions;
+        choices       = 1;
+        
+        for( i = 0; substitutions && i < length; i++ )
+        {
+            choices *= ( table.count( str[ i ] ) == 0 ) ? 1 : table.at( str[ i ] ).size() + 1;
+        }
+        
+        mask    = ( maxCharsForCaseVariants > 0 && length <= maxCharsForCaseVariants ) ? index / choices : 0;
+        choices = index % choices;
+        
+        variant.clear();
+        
+        for( i = 0; i < length; i++ )
+        {
+            c = ( ( mask >> i & 1 ) != 0 ) ? static_cast< char >( toupper( str[ i ] ) ) : str[ i ];
+            
+            if( substitutions == false || table.count( c ) == 0 )
+            {
+                variant += c;
+                
+                continue;
+            }
+            
+            radix    = table.at( c ).size() + 1;
+            choice   = choices % radix;
+            choices /= radix;
+            
+            if( choice == 0 )
+            {
+                variant += c;
+            }
+            else
+            {
+                variant += *( std::next( table.at( c ).begin(), static_cast< long >( choice - 1 ) ) );
+            }
+        }
+    }
+    
+    std::list< std::string > PasswordVariants::expand( const std::string & str, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions, const Constraints & constraints )
+    {
+        return PasswordVariantsConstrained
+        (
+            str,
+            maxCharsForCaseVariants        > 0 && str.length() <= maxCharsForCaseVariants,
+            maxCharsForCommonSubstitutions > 0 && str.length() <= maxCharsForCommonSubstitutions,
+            constraints
+        );
+    }
+    
+    std::list< std::string > PasswordVariants::caseVariants( const std::string & str, const Constraints & constraints )
+    {
+        return PasswordVariantsConstrained( str, true, false, constraints );
+    }
+    
+    std::list< std::string > PasswordVariants::commonSubstitutions( const std::string & str, const Constraints & constraints )
+    {
+        return PasswordVariantsConstrained( str, false, true, constraints );
+    }
+    
+    static std::list< std::string > PasswordVariantsConstrained( const std::string & str, bool caseVariants, bool substitutions, const Constraints & constraints )
+    {
+        const std::map< char, std::list< std::string > > & table = PasswordVariantsSubstitutions();
+        std::vector< std::vector< std::string > >          options;
+        std::vector< unsigned int >                        available;
+        std::vector< std::string >                         forms;
+        std::list< std::string >                           results;
+        std::string                                        candidate;
+        size_t                                             length;
+        size_t                                             position;
+        size_t                                             i;
+        size_t                                             n;
+        char                                               c;
+        
+        length = Constraints::characterLength( str.data(), str.length() );
+        
+        if( constraints.allowsLength( length ) == false )
+        {
+            return {};
+        }
+        
+        for( i = 0, position = 0; i < str.length(); i += n, position++ )
+        {
+            n     = Constraints::characterBytes( str.data() + i, str.length() - i );
+            c     = str[ i ];
+            forms = { str.substr( i, n ) };
+            
+            if( n == 1 && caseVariants && toupper( c ) != c )
+            {
+                forms.push_back( std::string( 1, static_cast< char >( toupper( c ) ) ) );
+            }
+            
+            if( n == 1 && substitutions && table.count( c ) > 0 )
+            {
+                for( const auto & v: table.at( c ) )
+                {
+                    if( std::find( forms.begin(), forms.end(), v ) == forms.end() )
+                    {
+                        forms.push_back( v );
+                    }
+                }
+            }
+            
+            forms.erase
+            (
+                std::remove_if
+                (
+                    forms.begin(),
+                    forms.end(),
+                    [ & ]( const std::string & f )
+                    {
+                        return constraints.allows( position, length, f.data(), f.length() ) == false;
+                    }
+                ),
+                forms.end()
+            );
+            
+            if( forms.empty() )
+            {
+                return {};
+            }
+            
+            options.push_back( forms );
+        }
+        
+        available.resize( options.size() + 1, Constraints::ClassNone );
+        
+        for( i = options.size(); i > 0; i-- )
+        {
+            available[ i - 1 ] = available[ i ];
+            
+            for( const auto & f: options[ i - 1 ] )
+            {
+                available[ i - 1 ] |= Constraints::classOf( f.data(), f.length() );
+            }
+        }
+        
+        PasswordVariantsVisit( options, available, constraints, 0, Constraints::ClassNone, candidate, results );
+        
+        return results;
+    }
+    
+    static void PasswordVariantsVisit( const std::vector< std::vector< std::string > > & options, const std::vector< unsigned int > & available, const Constraints & constraints, size_t position, unsigned int found, std::string & candidate, std::list< std::string > & results )
+    {
+        size_t size;
+        
+        if( ( constraints.required() & ~( found | available[ position ] ) ) != 0 )
+        {
+            return;
+        }
+        
+        if( position == options.size() )
+        {
+            results.push_back( candidate );
+            
+            return;
+        }
+        
+        size = candidate.size();
+        
+        for( const auto & f: options[ position ] )
+        {
+            candidate += f;
+            
+            PasswordVariantsVisit( options, available, constraints, position + 1, found | Constraints::classOf( f.data(), f.length() ), candidate, results );
+            candidate.resize( size );
+        }
+    }
+}
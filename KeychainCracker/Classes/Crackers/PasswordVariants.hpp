@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      PasswordVariants.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_PASSWORD_VARIANTS_HPP
+#define XS_PASSWORD_VARIANTS_HPP
+
+#include <string>
+#include <list>
+#include <cstddef>
+#include <cstdint>
+
+namespace XS
+{
+    class Constraints;
+    
+    /*!
+     * Case variants and common substitutions of a password.
+     * 
+     * Without constraints, the variants of a word form a mixed-radix
+     * keyspace, in the order given by expand(): variant i uses the case mask
+     * i / S, where bit j uppercases character j, and the substitution
+     * choices i % S, where S is the product of the number of choices of
+     * every character, and the first character varies fastest. Choice 0
+     * keeps the character. count() and variant() give the size of that
+     * keyspace and any of its variants without generating the others.
+     * 
+     * The overloads taking constraints don't follow that order: they
+     * offer each character, its uppercase form and its substitutions as
+     * a single set of choices, drop the choices the constraints reject,
+     * and enumerate the rest with the last character varying fastest.
+     */
+    class PasswordVariants
+    {
+        public:
+            
+            PasswordVariants( void ) = delete;
+            
+            static std::list< std::string > expand( const std::string & str, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions );
+            static std::list< std::string > caseVariants( const std::string & str );
+            static std::list< std::string > commonSubstitutions( const std::string & str );
+            
+            static uint64_t count( const char * str, size_t length, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions );
+            static void     variant( const char * str, size_t length, uint64_t index, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions, std::string & variant );
+            
+            static std::list< std::string > expand( const std::string & str, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions, const Constraints & constraints );
+            static std::list< std::string > caseVariants( const std::string & str, const Constraints & constraints );
+            static std::list< std::string > commonSubstitutions( const std::string & str, const Constraints & constraints );
+    };
+}
+
+#endif /* XS_PASSWORD_VARIANTS_HPP */
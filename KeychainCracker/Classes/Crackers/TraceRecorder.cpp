@@ -0,0 +1,303 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        TraceRecorder.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "TraceRecorder.hpp"
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+namespace XS
+{
+    static std::atomic< uint64_t > TraceRecorderNextID( 1 );
+    
+    class TraceRecorder::IMPL
+    {
+        public:
+            
+            struct Event
+            {
+                const char * name;
+                uint64_t     start;
+                uint64_t     duration;
+                uint64_t     count;
+            };
+            
+            struct Buffer
+            {
+                size_t                  tid;
+                std::string             name;
+                std::vector< Event >    events;
+                std::atomic< uint64_t > head;
+            };
+            
+            IMPL( size_t eventsPerThread );
+            ~IMPL( void );
+            
+            Buffer * buffer( void );
+            size_t   dropped( void ) const;
+            
+            static std::string escape( const std::string & s );
+            
+            uint64_t                _id;
+            size_t                  _eventsPerThread;
+            uint64_t                _origin;
+            mutable std::mutex      _mtx;
+            std::vector< Buffer * > _buffers;
+    };
+    
+    struct TraceRecorderThreadSlot
+    {
+        uint64_t   recorder;
+        void     * buffer;
+    };
+    
+    static thread_local TraceRecorderThreadSlot TraceRecorderSlot = { 0, nullptr };
+    
+    TraceRecorder::Span::Span( TraceRecorder * recorder, const char * name, uint64_t count ):
+        _recorder( recorder ),
+        _name(     name ),
+        _start(    ( recorder == nullptr ) ? 0 : TraceRecorder::now() ),
+        _count(    count )
+    {}
+    
+    TraceRecorder::Span::~Span( void )
+    {
+        if( this->_recorder != nullptr )
+        {
+            this->_recorder->record( this->_name, this->_start, TraceRecorder::now(), this->_count );
+        }
+    }
+    
+    void TraceRecorder::Span::count( uint64_t value )
+    {
+        this->_count = value;
+    }
+    
+    TraceRecorder::TraceRecorder( size_t eventsPerThread ):
+        impl( new IMPL( eventsPerThread ) )
+    {}
+    
+    TraceRecorder::~TraceRecorder( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( TraceRecorder & o1, TraceRecorder & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    uint64_t TraceRecorder::now( void )
+    {
+        return static_cast< uint64_t >( std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+    }
+    
+    size_t TraceRecorder::dropped( void ) const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        
+        return this->impl->dropped();
+    }
+    
+    void TraceRecorder::threadName( const std::string & name )
+    {
+        IMPL::Buffer                * buffer;
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        
+        buffer       = this->impl->buffer();
+        buffer->name = name;
+    }
+    
+    void TraceRecorder::record( const char * name, uint64_t start, uint64_t end, uint64_t count )
+    {
+        IMPL::Buffer * buffer;
+        IMPL::Event  * event;
+        uint64_t       head;
+        
+        if( TraceRecorderSlot.recorder == this->impl->_id )
+        {
+            buffer = static_cast< IMPL::Buffer * >( TraceRecorderSlot.buffer );
+        }
+        else
+        {
+            std::lock_guard< std::mutex > l( this->impl->_mtx );
+            
+            buffer = this->impl->buffer();
+        }
+        
+        head            = buffer->head.load( std::memory_order_relaxed );
+        event           = &( buffer->events[ static_cast< size_t >( head % buffer->events.size() ) ] );
+        event->name     = name;
+        event->start    = ( start > this->impl->_origin ) ? start - this->impl->_origin : 0;
+        event->duration = ( end > start ) ? end - start : 0;
+        event->count    = count;
+        
+        buffer->head.store( head + 1, std::memory_order_release );
+    }
+    
+    bool TraceRecorder::write( const std::string & path ) const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        FILE                        * fp;
+        uint64_t                      head;
+        uint64_t                      i;
+        bool                          ok;
+        
+        fp = fopen( path.c_str(), "wb" );
+        
+        if( fp == nullptr )
+        {
+            return false;
+        }
+        
+        fprintf( fp, "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":%zu},\"traceEvents\":[\n", this->impl->dropped() );
+        fprintf( fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"KeychainCracker\"}}" );
+        
+        for( const auto buffer: this->impl->_buffers )
+        {
+            if( buffer->name.empty() == false )
+            {
+                fprintf( fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"%s\"}}", buffer->tid, IMPL::escape( buffer->name ).c_str() );
+            }
+            
+            head = buffer->head.load( std::memory_order_acquire );
+            
+            for( i = ( head > buffer->events.size() ) ? head - buffer->events.size() : 0; i < head; i++ )
+            {
+                const IMPL::Event & event = buffer->events[ static_cast< size_t >( i % buffer->events.size() ) ];
+                
+                fprintf
+                (
+                    fp,
+                    ",\n{\"name\":\"%s\",\"cat\":\"pipeline\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%llu,\"dur\":%llu,\"args\":{\"count\":%llu}}",
+                    IMPL::escape( event.name ).c_str(),
+                    buffer->tid,
+                    static_cast< unsigned long long >( event.start ),
+                    static_cast< unsigned long long >( event.duration ),
+                    static_cast< unsigned long long >( event.count )
+                );
+            }
+        }
+        
+        fprintf( fp, "\n]}\n" );
+        
+        ok = ferror( fp ) == 0;
+        
+        return fclose( fp ) == 0 && ok;
+    }
+    
+    TraceRecorder::IMPL::IMPL( size_t eventsPerThread ):
+        _id(              TraceRecorderNextID++ ),
+        _eventsPerThread( ( eventsPerThread > 0 ) ? eventsPerThread : 1 ),
+        _origin(          TraceRecorder::now() )
+    {}
+    
+    TraceRecorder::IMPL::~IMPL( void )
+    {
+        for( const auto buffer: this->_buffers )
+        {
+            delete buffer;
+        }
+    }
+    
+    TraceRecorder::IMPL::Buffer * TraceRecorder::IMPL::buffer( void )
+    {
+        Buffer * buffer;
+        
+        if( TraceRecorderSlot.recorder == this->_id )
+        {
+            return static_cast< Buffer * >( TraceRecorderSlot.buffer );
+        }
+        
+        buffer = new Buffer();
+        
+        buffer->tid = this->_buffers.size() + 1;
+        buffer->head.store( 0 );
+        buffer->events.resize( this->_eventsPerThread );
+        
+        this->_buffers.push_back( buffer );
+        
+        TraceRecorderSlot.recorder = this->_id;
+        TraceRecorderSlot.buffer   = buffer;
+        
+        return buffer;
+    }
+    
+    size_t TraceRecorder::IMPL::dropped( void ) const
+    {
+        size_t   n;
+        uint64_t head;
+        
+        n = 0;
+        
+        for( const auto buffer: this->_buffers )
+        {
+            head = buffer->head.load( std::memory_order_acquire );
+            
+            if( head > buffer->events.size() )
+            {
+                n += static_cast< size_t >( head - buffer->events.size() );
+            }
+        }
+        
+        return n;
+    }
+    
+    std::string TraceRecorder::IMPL::escape( const std::string & s )
+    {
+        std::string out;
+        char        hex[ 7 ];
+        
+        for( char c: s )
+        {
+            if( c == '"' || c == '\\' )
+            {
+                out += '\\';
+                out += c;
+            }
+            else if( static_cast< unsigned char >( c ) < 0x20 )
+            {
+                snprintf( hex, sizeof( hex ), "\\u%04x", static_cast< unsigned int >( static_cast< unsigned char >( c ) ) );
+                
+                out += hex;
+            }
+            else
+            {
+                out += c;
+            }
+        }
+        
+        return out;
+    }
+}
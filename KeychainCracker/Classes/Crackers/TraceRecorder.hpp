@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      TraceRecorder.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_TRACE_RECORDER_HPP
+#define XS_TRACE_RECORDER_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace XS
+{
+    /*!
+     * Records timed spans from every thread taking part in a run, and writes
+     * them as a Chrome trace-event JSON file (chrome://tracing, Perfetto).
+     * 
+     * Each thread appends to its own ring buffer, so recording never takes a
+     * lock once a thread is registered. When a ring is full, its oldest
+     * events are overwritten; dropped() counts them, and the written file
+     * records that count as otherData.droppedEvents.
+     */
+    class TraceRecorder
+    {
+        public:
+            
+            class Span
+            {
+                public:
+                    
+                    Span( TraceRecorder * recorder, const char * name, uint64_t count = 0 );
+                    ~Span( void );
+                    
+                    Span( const Span & o )              = delete;
+                    Span & operator =( const Span & o ) = delete;
+                    
+                    void count( uint64_t value );
+                    
+                private:
+                    
+                    TraceRecorder * _recorder;
+                    const char    * _name;
+                    uint64_t        _start;
+                    uint64_t        _count;
+            };
+            
+            explicit TraceRecorder( size_t eventsPerThread = 65536 );
+            ~TraceRecorder( void );
+            
+            TraceRecorder( const TraceRecorder & o )      = delete;
+            TraceRecorder( TraceRecorder && o )           = delete;
+            TraceRecorder & operator =( TraceRecorder o ) = delete;
+            
+            friend void swap( TraceRecorder & o1, TraceRecorder & o2 );
+            
+            static uint64_t now( void );
+            
+            size_t dropped( void ) const;
+            
+            void threadName( const std::string & name );
+            void record( const char * name, uint64_t start, uint64_t end, uint64_t count );
+            bool write( const std::string & path ) const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_TRACE_RECORDER_HPP */
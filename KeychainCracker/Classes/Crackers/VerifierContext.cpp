@@ -0,0 +1,258 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        VerifierContext.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "VerifierContext.hpp"
+#include "KeychainTarget.hpp"
+#include "KeychainVerifier.hpp"
+#include <stdexcept>
+#include <fstream>
+#include <vector>
+#include <mutex>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <dirent.h>
+#include <Security/Security.h>
+
+namespace XS
+{
+    static const char * VerifierContextPrefix    = "KeychainCracker-";
+    static const char * VerifierContextExtension = ".keychain-db";
+    
+    static std::string VerifierContextCopy( const std::string & path );
+    static void        VerifierContextCleanup( const std::string & dir );
+    
+    class VerifierContext::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & keychain );
+            ~IMPL( void );
+            
+            KeychainTarget   * _target;
+            KeychainVerifier * _verifier;
+            SecKeychainRef     _keychain;
+            std::string        _copy;
+    };
+    
+    VerifierContext::VerifierContext( const std::string & keychain ):
+        impl( new IMPL( keychain ) )
+    {}
+    
+    VerifierContext::~VerifierContext( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( VerifierContext & o1, VerifierContext & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    bool VerifierContext::verify( const char * password, size_t length )
+    {
+        if( this->impl->_verifier != nullptr )
+        {
+            return this->impl->_verifier->verify( password, length );
+        }
+        
+        return SecKeychainUnlock( this->impl->_keychain, static_cast< UInt32 >( length ), password, TRUE ) == noErr;
+    }
+    
+    VerifierContext::IMPL::IMPL( const std::string & keychain ):
+        _target(   nullptr ),
+        _verifier( nullptr ),
+        _keychain( nullptr )
+    {
+        if( KeychainTarget::isTarget( keychain ) )
+        {
+            this->_target = new KeychainTarget( keychain );
+            
+            try
+            {
+                this->_verifier = new KeychainVerifier( *( this->_target ) );
+            }
+            catch( ... )
+            {
+                delete this->_target;
+                
+                throw;
+            }
+            
+            return;
+        }
+        
+        this->_copy = VerifierContextCopy( keychain );
+        
+        if( SecKeychainOpen( this->_copy.c_str(), &( this->_keychain ) ) != noErr || this->_keychain == nullptr )
+        {
+            unlink( this->_copy.c_str() );
+            
+            throw std::runtime_error( std::string( "Cannot open keychain copy " ) + this->_copy );
+        }
+        
+        SecKeychainLock( this->_keychain );
+    }
+    
+    VerifierContext::IMPL::~IMPL( void )
+    {
+        if( this->_keychain != nullptr )
+        {
+            CFRelease( this->_keychain );
+        }
+        
+        if( this->_copy.length() > 0 )
+        {
+            unlink( this->_copy.c_str() );
+        }
+        
+        delete this->_verifier;
+        delete this->_target;
+    }
+    
+    static std::string VerifierContextCopy( const std::string & path )
+    {
+        static std::once_flag once;
+        std::string           dir;
+        std::string           file;
+        std::vector< char >   name;
+        const char          * tmp;
+        int                   fd;
+        std::streamoff        size;
+        bool                  copied;
+        
+        tmp = getenv( "TMPDIR" );
+        dir = ( tmp != nullptr && tmp[ 0 ] != 0 ) ? tmp : "/tmp";
+        
+        if( dir[ dir.length() - 1 ] != '/' )
+        {
+            dir += "/";
+        }
+        
+        std::call_once
+        (
+            once,
+            [ & ]
+            {
+                VerifierContextCleanup( dir );
+            }
+        );
+        
+        file = dir + VerifierContextPrefix + std::to_string( getpid() ) + "-XXXXXX" + VerifierContextExtension;
+        
+        name.assign( file.begin(), file.end() );
+        name.push_back( 0 );
+        
+        fd = mkstemps( &( name[ 0 ] ), static_cast< int >( strlen( VerifierContextExtension ) ) );
+        
+        if( fd == -1 )
+        {
+            throw std::runtime_error( std::string( "Cannot create keychain copy for " ) + path );
+        }
+        
+        close( fd );
+        
+        {
+            std::ifstream in( path, std::ios::binary | std::ios::ate );
+            std::ofstream out( &( name[ 0 ] ), std::ios::binary | std::ios::trunc );
+            
+            size = ( in.good() ) ? static_cast< std::streamoff >( in.tellg() ) : 0;
+            
+            in.seekg( 0 );
+            
+            if( size > 0 && in.good() && out.good() )
+            {
+                out << in.rdbuf();
+            }
+            
+            copied = size > 0 && out.good() && static_cast< std::streamoff >( out.tellp() ) == size;
+            
+            out.close();
+            
+            if( copied == false || out.fail() )
+            {
+                unlink( &( name[ 0 ] ) );
+                
+                throw std::runtime_error( std::string( "Cannot copy keychain " ) + path );
+            }
+        }
+        
+        return std::string( &( name[ 0 ] ) );
+    }
+    
+    static void VerifierContextCleanup( const std::string & dir )
+    {
+        DIR           * d;
+        struct dirent * e;
+        std::string     file;
+        size_t          prefix;
+        size_t          suffix;
+        char          * end;
+        long            pid;
+        
+        d = opendir( dir.c_str() );
+        
+        if( d == nullptr )
+        {
+            return;
+        }
+        
+        prefix = strlen( VerifierContextPrefix );
+        suffix = strlen( VerifierContextExtension );
+        
+        while( ( e = readdir( d ) ) != nullptr )
+        {
+            file = e->d_name;
+            
+            if( file.length() <= prefix + suffix || file.compare( 0, prefix, VerifierContextPrefix ) != 0 || file.compare( file.length() - suffix, suffix, VerifierContextExtension ) != 0 )
+            {
+                continue;
+            }
+            
+            pid = strtol( file.c_str() + prefix, &end, 10 );
+            
+            if( pid <= 0 || *( end ) != '-' || pid == static_cast< long >( getpid() ) )
+            {
+                continue;
+            }
+            
+            if( kill( static_cast< pid_t >( pid ), 0 ) == -1 && errno == ESRCH )
+            {
+                unlink( ( dir + file ).c_str() );
+            }
+        }
+        
+        closedir( d );
+    }
+}
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      VerifierContext.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_VERIFIER_CONTEXT_HPP
+#define XS_VERIFIER_CONTEXT_HPP
+
+#include <string>
+#include <cstddef>
+
+namespace XS
+{
+    /*!
+     * Everything one worker thread needs to test passwords, owned by that
+     * thread alone.
+     * 
+     * Unlock attempts on a single SecKeychainRef are serialized by the
+     * Security framework, so worker threads sharing one handle mostly wait
+     * for each other. A context for a keychain-db file opens a private copy
+     * of the file, giving each worker an independent database. A context
+     * for a target descriptor loads its own target and verifier.
+     * 
+     * The keychain copy is removed when the context is destroyed. Copies
+     * are named after the process that made them, and copies left behind
+     * by processes that are no longer running are removed when the first
+     * context of a process is created.
+     */
+    class VerifierContext
+    {
+        public:
+            
+            explicit VerifierContext( const std::string & keychain );
+            ~VerifierContext( void );
+            
+            VerifierContext( const VerifierContext & o )      = delete;
+            VerifierContext( VerifierContext && o )           = delete;
+            VerifierContext & operator =( VerifierContext o ) = delete;
+            
+            friend void swap( VerifierContext & o1, VerifierContext & o2 );
+            
+            bool verify( const char * password, size_t length );
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_VERIFIER_CONTEXT_HPP */
@@ -0,0 +1,500 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        DaemonServer.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "DaemonServer.hpp"
+#include "JobScheduler.hpp"
+#include <stdexcept>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+namespace XS
+{
+    static volatile sig_atomic_t DaemonServerInterrupted = 0;
+    
+    static void DaemonServerSignalHandler( int sig )
+    {
+        ( void )sig;
+        
+        DaemonServerInterrupted = 1;
+    }
+    
+    static bool DaemonServerAddress( const std::string & path, struct sockaddr_un & address )
+    {
+        memset( &address, 0, sizeof( address ) );
+        
+        if( path.length() >= sizeof( address.sun_path ) )
+        {
+            return false;
+        }
+        
+        address.sun_family = AF_UNIX;
+        
+        memcpy( address.sun_path, path.c_str(), path.length() );
+        
+        return true;
+    }
+    
+    static bool DaemonServerReadLine( int fd, std::string & buffer, std::string & line )
+    {
+        char    data[ 4096 ];
+        size_t  pos;
+        ssize_t n;
+        
+        while( ( pos = buffer.find( '\n' ) ) == std::string::npos )
+        {
+            n = read( fd, data, sizeof( data ) );
+            
+            if( n <= 0 )
+            {
+                if( buffer.empty() )
+                {
+                    return false;
+                }
+                
+                line = buffer;
+                
+                buffer.clear();
+                
+                return true;
+            }
+            
+            buffer.append( data, static_cast< size_t >( n ) );
+        }
+        
+        line = buffer.substr( 0, pos );
+        
+        buffer.erase( 0, pos + 1 );
+        
+        if( line.length() > 0 && line[ line.length() - 1 ] == '\r' )
+        {
+            line.erase( line.length() - 1 );
+        }
+        
+        return true;
+    }
+    
+    static bool DaemonServerWrite( int fd, const std::string & data )
+    {
+        size_t  written;
+        ssize_t n;
+        
+        written = 0;
+        
+        while( written < data.length() )
+        {
+            n = write( fd, data.c_str() + written, data.length() - written );
+            
+            if( n <= 0 )
+            {
+                return false;
+            }
+            
+            written += static_cast< size_t >( n );
+        }
+        
+        return true;
+    }
+    
+    static std::vector< std::string > DaemonServerSplit( const std::string & line )
+    {
+        std::vector< std::string > fields;
+        size_t                     start;
+        size_t                     end;
+        
+        start = 0;
+        
+        while( start <= line.length() )
+        {
+            end = line.find( '\t', start );
+            
+            if( end == std::string::npos )
+            {
+                end = line.length();
+            }
+            
+            if( end > start )
+            {
+                fields.push_back( line.substr( start, end - start ) );
+            }
+            
+            start = end + 1;
+        }
+        
+        return fields;
+    }
+    
+    class DaemonServer::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & socketPath, JobScheduler & scheduler );
+            ~IMPL( void );
+            
+            void                       serve( int fd );
+            std::vector< std::string > respond( const std::vector< std::string > & fields );
+            
+            static std::string describe( const JobScheduler::JobInfo & info );
+            
+            std::string    _path;
+            JobScheduler & _scheduler;
+            int            _socket;
+            bool           _stopping;
+    };
+    
+    DaemonServer::DaemonServer( const std::string & socketPath, JobScheduler & scheduler ):
+        impl( new IMPL( socketPath, scheduler ) )
+    {}
+    
+    DaemonServer::~DaemonServer( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( DaemonServer & o1, DaemonServer & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    std::string DaemonServer::defaultSocketPath( void )
+    {
+        const char * tmp;
+        std::string  dir;
+        
+        tmp = getenv( "TMPDIR" );
+        dir = ( tmp != nullptr && strlen( tmp ) > 0 ) ? tmp : "/tmp";
+        
+        if( dir[ dir.length() - 1 ] != '/' )
+        {
+            dir += "/";
+        }
+        
+        return dir + "KeychainCracker-" + std::to_string( getuid() ) + ".sock";
+    }
+    
+    void DaemonServer::handleSignals( void )
+    {
+        signal( SIGINT,  DaemonServerSignalHandler );
+        signal( SIGTERM, DaemonServerSignalHandler );
+        signal( SIGPIPE, SIG_IGN );
+    }
+    
+    bool DaemonServer::request( const std::string & socketPath, const std::vector< std::string > & fields, std::vector< std::string > & response )
+    {
+        struct sockaddr_un address;
+        int                fd;
+        std::string        line;
+        std::string        buffer;
+        
+        response.clear();
+        
+        if( DaemonServerAddress( socketPath, address ) == false )
+        {
+            throw std::runtime_error( "Socket path is too long: " + socketPath );
+        }
+        
+        fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+        
+        if( fd < 0 || connect( fd, reinterpret_cast< struct sockaddr * >( &address ), sizeof( address ) ) != 0 )
+        {
+            if( fd >= 0 )
+            {
+                close( fd );
+            }
+            
+            throw std::runtime_error( "Cannot connect to the daemon at " + socketPath );
+        }
+        
+        signal( SIGPIPE, SIG_IGN );
+        
+        for( const auto & field: fields )
+        {
+            line += ( ( line.empty() ) ? "" : "\t" ) + field;
+        }
+        
+        DaemonServerWrite( fd, line + "\n" );
+        shutdown( fd, SHUT_WR );
+        
+        while( DaemonServerReadLine( fd, buffer, line ) )
+        {
+            response.push_back( line );
+            
+            if( line.compare( 0, 2, "OK" ) == 0 || line.compare( 0, 5, "ERROR" ) == 0 )
+            {
+                break;
+            }
+        }
+        
+        close( fd );
+        
+        return response.size() > 0 && response.back().compare( 0, 2, "OK" ) == 0;
+    }
+    
+    void DaemonServer::run( void )
+    {
+        struct pollfd p;
+        int           fd;
+        
+        while( this->impl->_stopping == false && DaemonServerInterrupted == 0 )
+        {
+            p.fd      = this->impl->_socket;
+            p.events  = POLLIN;
+            p.revents = 0;
+            
+            if( poll( &p, 1, 500 ) <= 0 )
+            {
+                continue;
+            }
+            
+            fd = accept( this->impl->_socket, nullptr, nullptr );
+            
+            if( fd < 0 )
+            {
+                continue;
+            }
+            
+            this->impl->serve( fd );
+            
+            close( fd );
+        }
+    }
+    
+    DaemonServer::IMPL::IMPL( const std::string & socketPath, JobScheduler & scheduler ):
+        _path(      socketPath ),
+        _scheduler( scheduler ),
+        _socket(    -1 ),
+        _stopping(  false )
+    {
+        struct sockaddr_un address;
+        int                fd;
+        
+        if( DaemonServerAddress( socketPath, address ) == false )
+        {
+            throw std::runtime_error( "Socket path is too long: " + socketPath );
+        }
+        
+        fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+        
+        if( fd >= 0 && connect( fd, reinterpret_cast< struct sockaddr * >( &address ), sizeof( address ) ) == 0 )
+        {
+            close( fd );
+            
+            throw std::runtime_error( "A daemon is already listening on " + socketPath );
+        }
+        
+        if( fd >= 0 )
+        {
+            close( fd );
+        }
+        
+        unlink( socketPath.c_str() );
+        
+        this->_socket = socket( AF_UNIX, SOCK_STREAM, 0 );
+        
+        if
+        (
+               this->_socket < 0
+            || bind( this->_socket, reinterpret_cast< struct sockaddr * >( &address ), sizeof( address ) ) != 0
+            || chmod( socketPath.c_str(), S_IRUSR | S_IWUSR ) != 0
+            || listen( this->_socket, 16 ) != 0
+        )
+        {
+            std::string error( strerror( errno ) );
+            
+            if( this->_socket >= 0 )
+            {
+                close( this->_socket );
+            }
+            
+            throw std::runtime_error( "Cannot listen on " + socketPath + ": " + error );
+        }
+    }
+    
+    DaemonServer::IMPL::~IMPL( void )
+    {
+        close( this->_socket );
+        unlink( this->_path.c_str() );
+    }
+    
+    void DaemonServer::IMPL::serve( int fd )
+    {
+        struct timeval timeout;
+        std::string    buffer;
+        std::string    line;
+        
+        timeout.tv_sec  = 5;
+        timeout.tv_usec = 0;
+        
+        setsockopt( fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof( timeout ) );
+        
+        while( this->_stopping == false && DaemonServerReadLine( fd, buffer, line ) )
+        {
+            std::vector< std::string > fields;
+            
+            fields = DaemonServerSplit( line );
+            
+            if( fields.empty() )
+            {
+                continue;
+            }
+            
+            for( const auto & response: this->respond( fields ) )
+            {
+                if( DaemonServerWrite( fd, response + "\n" ) == false )
+                {
+                    return;
+                }
+            }
+        }
+    }
+    
+    std::vector< std::string > DaemonServer::IMPL::respond( const std::vector< std::string > & fields )
+    {
+        const std::string        & command = fields[ 0 ];
+        std::vector< std::string > lines;
+        JobScheduler::JobSpec      spec;
+        JobScheduler::JobInfo      info;
+        uint64_t                   id;
+        bool                       ok;
+        
+        try
+        {
+            if( command == "submit" && fields.size() >= 3 && fields.size() <= 6 )
+            {
+                spec.keychain                       = fields[ 1 ];
+                spec.wordList                       = fields[ 2 ];
+                spec.priority                       = ( fields.size() > 3 ) ? static_cast< unsigned int >( std::stoul( fields[ 3 ] ) ) : JobScheduler::DefaultPriority;
+                spec.maxCharsForCaseVariants        = ( fields.size() > 4 ) ? std::stoul( fields[ 4 ] ) : 0;
+                spec.maxCharsForCommonSubstitutions = ( fields.size() > 5 ) ? std::stoul( fields[ 5 ] ) : 0;
+                
+                return { "OK\t" + std::to_string( this->_scheduler.submit( spec ) ) };
+            }
+            
+            if( command == "list" && fields.size() == 1 )
+            {
+                lines.push_back
+                (
+                    std::string( "POOL\t" )
+                    + std::to_string( this->_scheduler.activeWorkers() ) + "\t"
+                    + std::to_string( this->_scheduler.maxWorkers() )    + "\t"
+                    + std::to_string( this->_scheduler.rate() )
+                );
+                
+                for( const auto & job: this->_scheduler.jobs() )
+                {
+                    lines.push_back( IMPL::describe( job ) );
+                }
+                
+                lines.push_back( "OK" );
+                
+                return lines;
+            }
+            
+            if( command == "shutdown" && fields.size() == 1 )
+            {
+                this->_stopping = true;
+                
+                return { "OK" };
+            }
+            
+            if( fields.size() < 2 )
+            {
+                return { "ERROR\tInvalid request" };
+            }
+            
+            id = std::stoull( fields[ 1 ] );
+            
+            if( command == "status" && fields.size() == 2 )
+            {
+                ok = this->_scheduler.job( id, info );
+                
+                if( ok )
+                {
+                    lines.push_back( IMPL::describe( info ) );
+                }
+            }
+            else if( command == "pause" && fields.size() == 2 )
+            {
+                ok = this->_scheduler.pause( id );
+            }
+            else if( command == "resume" && fields.size() == 2 )
+            {
+                ok = this->_scheduler.resume( id );
+            }
+            else if( command == "cancel" && fields.size() == 2 )
+            {
+                ok = this->_scheduler.cancel( id );
+            }
+            else if( command == "priority" && fields.size() == 3 )
+            {
+                ok = this->_scheduler.priority( id, static_cast< unsigned int >( std::stoul( fields[ 2 ] ) ) );
+            }
+            else
+            {
+                return { "ERROR\tInvalid request" };
+            }
+            
+            lines.push_back( ( ok ) ? "OK" : "ERROR\tNo such job, or invalid job state for " + command );
+        }
+        catch( const std::exception & e )
+        {
+            lines.push_back( std::string( "ERROR\t" ) + e.what() );
+        }
+        
+        return lines;
+    }
+    
+    std::string DaemonServer::IMPL::describe( const JobScheduler::JobInfo & info )
+    {
+        char progress[ 16 ] = { 0 };
+        
+        snprintf( progress, sizeof( progress ), "%.1f%%", info.progress * 100 );
+        
+        return std::string( "JOB\t" )
+             + std::to_string( info.id )                  + "\t"
+             + JobScheduler::stateName( info.state )      + "\t"
+             + std::to_string( info.spec.priority )       + "\t"
+             + std::to_string( info.processed )           + "\t"
+             + std::to_string( info.rate )                + "\t"
+             + progress                                   + "\t"
+             + info.spec.keychain                         + "\t"
+             + info.spec.wordList                         + "\t"
+             + info.password;
+    }
+}
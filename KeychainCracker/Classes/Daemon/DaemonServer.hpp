@@ -0,0 +1,83 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      DaemonServer.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_DAEMON_SERVER_HPP
+#define XS_DAEMON_SERVER_HPP
+
+#include <string>
+#include <vector>
+
+namespace XS
+{
+    class JobScheduler;
+    
+    /*!
+     * Serves a JobScheduler over a local (UNIX domain) socket.
+     * 
+     * The protocol is line based: each request is one line, with fields
+     * separated by tabs, and each response ends with a line starting with
+     * "OK" or "ERROR".
+     * 
+     *     submit   <keychain> <word list> [priority] [case-max] [subst-max]
+     *     list
+     *     status   <id>
+     *     pause    <id>
+     *     resume   <id>
+     *     priority <id> <priority>
+     *     cancel   <id>
+     *     shutdown
+     */
+    class DaemonServer
+    {
+        public:
+            
+            DaemonServer( const std::string & socketPath, JobScheduler & scheduler );
+            ~DaemonServer( void );
+            
+            DaemonServer( const DaemonServer & o )      = delete;
+            DaemonServer( DaemonServer && o )           = delete;
+            DaemonServer & operator =( DaemonServer o ) = delete;
+            
+            friend void swap( DaemonServer & o1, DaemonServer & o2 );
+            
+            static std::string defaultSocketPath( void );
+            static void        handleSignals( void );
+            static bool        request( const std::string & socketPath, const std::vector< std::string > & fields, std::vector< std::string > & response );
+            
+            void run( void );
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_DAEMON_SERVER_HPP */
@@ -0,0 +1,660 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        JobScheduler.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "JobScheduler.hpp"
+#include "ConcurrencyController.hpp"
+#include "CandidateSource.hpp"
+#include "CompiledWordList.hpp"
+#include "CompiledWordListSource.hpp"
+#include "WordListStream.hpp"
+#include "PasswordVariants.hpp"
+#include "KeychainTarget.hpp"
+#include "KeychainVerifier.hpp"
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+#include <Security/Security.h>
+
+namespace XS
+{
+    static const uint64_t JobSchedulerStride    = 1 << 20;
+    static const size_t   JobSchedulerBatchSize = 128;
+    
+    const unsigned int JobScheduler::DefaultPriority;
+    const unsigned int JobScheduler::MaxPriority;
+    
+    class JobScheduler::IMPL
+    {
+        public:
+            
+            struct Job
+            {
+                uint64_t                     id;
+                JobSpec                      spec;
+                std::atomic< JobState >      state;
+                SecKeychainRef               keychain;
+                std::mutex                   verification;
+                KeychainTarget             * target;
+                KeychainVerifier           * verifier;
+                CompiledWordList           * wordList;
+                CandidateSource            * source;
+                bool                         expand;
+                bool                         exhausted;
+                size_t                       inflight;
+                uint64_t                     pass;
+                std::atomic< unsigned long > processed;
+                unsigned long                lastProcessed;
+                unsigned long                rate;
+                double                       progress;
+                std::string                  password;
+            };
+            
+            IMPL( size_t maxWorkers, bool adaptive );
+            ~IMPL( void );
+            
+            void  work( size_t worker );
+            void  monitor( void );
+            Job * pick( void );
+            bool  tryPassword( Job * job, const char * password, size_t length );
+            bool  unlock( Job * job, const char * password, size_t length );
+            void  release( Job * job );
+            void  log( const std::string & message );
+            
+            static JobInfo info( const Job * job );
+            
+            ConcurrencyController         _controller;
+            std::map< uint64_t, Job * >   _jobs;
+            mutable std::mutex            _mtx;
+            std::condition_variable       _cv;
+            std::vector< std::thread >    _workers;
+            std::thread                   _monitor;
+            bool                          _stopping;
+            uint64_t                      _nextID;
+            uint64_t                      _virtualTime;
+            std::atomic< unsigned long >  _processed;
+            unsigned long                 _lastProcessed;
+            std::atomic< unsigned long >  _rate;
+            
+            std::function< void( const std::string & ) > _log;
+    };
+    
+    JobScheduler::JobScheduler( size_t maxWorkers, bool adaptive ):
+        impl( new IMPL( maxWorkers, adaptive ) )
+    {}
+    
+    JobScheduler::~JobScheduler( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( JobScheduler & o1, JobScheduler & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    std::string JobScheduler::stateName( JobState state )
+    {
+        switch( state )
+        {
+            case JobStateRunning:   return "running";
+            case JobStatePaused:    return "paused";
+            case JobStateFound:     return "found";
+            case JobStateExhausted: return "exhausted";
+            case JobStateCancelled: return "cancelled";
+        }
+        
+        return "unknown";
+    }
+    
+    size_t JobScheduler::maxWorkers( void ) const
+    {
+        return this->impl->_controller.maxWorkers();
+    }
+    
+    size_t JobScheduler::activeWorkers( void ) const
+    {
+        return this->impl->_controller.activeWorkers();
+    }
+    
+    unsigned long JobScheduler::rate( void ) const
+    {
+        return this->impl->_rate;
+    }
+    
+    std::vector< JobScheduler::JobInfo > JobScheduler::jobs( void ) const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        std::vector< JobInfo >        jobs;
+        
+        for( const auto & p: this->impl->_jobs )
+        {
+            jobs.push_back( IMPL::info( p.second ) );
+        }
+        
+        return jobs;
+    }
+    
+    bool JobScheduler::job( uint64_t id, JobInfo & info ) const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        
+        if( this->impl->_jobs.count( id ) == 0 )
+        {
+            return false;
+        }
+        
+        info = IMPL::info( this->impl->_jobs.at( id ) );
+        
+        return true;
+    }
+    
+    uint64_t JobScheduler::submit( const JobSpec & spec )
+    {
+        IMPL::Job * job;
+        uint64_t    id;
+        
+        job                = new IMPL::Job();
+        job->spec          = spec;
+        job->spec.priority = std::min( std::max( spec.priority, 1U ), MaxPriority );
+        job->keychain      = nullptr;
+        job->target        = nullptr;
+        job->verifier      = nullptr;
+        job->wordList      = nullptr;
+        job->source        = nullptr;
+        job->expand        = spec.maxCharsForCaseVariants > 0 || spec.maxCharsForCommonSubstitutions > 0;
+        job->exhausted     = false;
+        job->inflight      = 0;
+        job->lastProcessed = 0;
+        job->rate          = 0;
+        job->progress      = 0;
+        
+        job->state.store( JobStateRunning );
+        job->processed.store( 0 );
+        
+        try
+        {
+            if( KeychainTarget::isTarget( spec.keychain ) )
+            {
+                job->target   = new KeychainTarget( spec.keychain );
+                job->verifier = new KeychainVerifier( *( job->target ) );
+            }
+            else if( SecKeychainOpen( spec.keychain.c_str(), &( job->keychain ) ) != noErr || job->keychain == nullptr )
+            {
+                throw std::runtime_error( std::string( "Cannot open keychain " ) + spec.keychain );
+            }
+            
+            if( CompiledWordList::isCompiledWordList( spec.wordList ) )
+            {
+                job->wordList = new CompiledWordList( spec.wordList );
+                job->source   = new CompiledWordListSource( *( job->wordList ) );
+            }
+            else
+            {
+                job->source = new WordListStream( spec.wordList );
+            }
+        }
+        catch( ... )
+        {
+            job->state = JobStateCancelled;
+            
+            this->impl->release( job );
+            
+            delete job;
+            
+            throw;
+        }
+        
+        if( job->keychain != nullptr )
+        {
+            SecKeychainLock( job->keychain );
+        }
+        
+        job->source->restart();
+        
+        {
+            std::lock_guard< std::mutex > l( this->impl->_mtx );
+            
+            id        = this->impl->_nextID++;
+            job->id   = id;
+            job->pass = this->impl->_virtualTime;
+            
+            this->impl->_jobs[ id ] = job;
+        }
+        
+        this->impl->_cv.notify_all();
+        this->impl->log( "job " + std::to_string( id ) + " submitted: " + spec.keychain + ", " + spec.wordList );
+        
+        return id;
+    }
+    
+    bool JobScheduler::pause( uint64_t id )
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        
+        if( this->impl->_jobs.count( id ) == 0 || this->impl->_jobs[ id ]->state != JobStateRunning )
+        {
+            return false;
+        }
+        
+        this->impl->_jobs[ id ]->state = JobStatePaused;
+        
+        return true;
+    }
+    
+    bool JobScheduler::resume( uint64_t id )
+    {
+        {
+            std::lock_guard< std::mutex > l( this->impl->_mtx );
+            IMPL::Job                   * job;
+            
+            if( this->impl->_jobs.count( id ) == 0 || this->impl->_jobs[ id ]->state != JobStatePaused )
+            {
+                return false;
+            }
+            
+            job        = this->impl->_jobs[ id ];
+            job->state = ( job->exhausted && job->inflight == 0 ) ? JobStateExhausted : JobStateRunning;
+            job->pass  = std::max( job->pass, this->impl->_virtualTime );
+            
+            this->impl->release( job );
+        }
+        
+        this->impl->_cv.notify_all();
+        
+        return true;
+    }
+    
+    bool JobScheduler::priority( uint64_t id, unsigned int priority )
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        
+        if( this->impl->_jobs.count( id ) == 0 )
+        {
+            return false;
+        }
+        
+        this->impl->_jobs[ id ]->spec.priority = std::min( std::max( priority, 1U ), MaxPriority );
+        
+        return true;
+    }
+    
+    bool JobScheduler::cancel( uint64_t id )
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        IMPL::Job                   * job;
+        
+        if( this->impl->_jobs.count( id ) == 0 )
+        {
+            return false;
+        }
+        
+        job = this->impl->_jobs[ id ];
+        
+        if( job->state != JobStateRunning && job->state != JobStatePaused )
+        {
+            return false;
+        }
+        
+        job->state = JobStateCancelled;
+        
+        this->impl->release( job );
+        
+        return true;
+    }
+    
+    void JobScheduler::logger( const std::function< void( const std::string & ) > & log )
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        
+        this->impl->_log = log;
+        
+        this->impl->_controller.logger( log );
+    }
+    
+    JobScheduler::IMPL::IMPL( size_t maxWorkers, bool adaptive ):
+        _controller(    maxWorkers, adaptive ),
+        _stopping(      false ),
+        _nextID(        1 ),
+        _virtualTime(   0 ),
+        _processed(     0 ),
+        _lastProcessed( 0 ),
+        _rate(          0 )
+    {
+        size_t i;
+        
+        for( i = 0; i < this->_controller.maxWorkers(); i++ )
+        {
+            this->_workers.push_back
+            (
+                std::thread
+                (
+                    [ this, i ]
+                    {
+                        this->work( i );
+                    }
+                )
+            );
+        }
+        
+        this->_monitor = std::thread
+        (
+            [ this ]
+            {
+                this->monitor();
+            }
+        );
+    }
+    
+    JobScheduler::IMPL::~IMPL( void )
+    {
+        {
+            std::lock_guard< std::mutex > l( this->_mtx );
+            
+            this->_stopping = true;
+            
+            for( const auto & p: this->_jobs )
+            {
+                if( p.second->state == JobStateRunning || p.second->state == JobStatePaused )
+                {
+                    p.second->state = JobStateCancelled;
+                }
+            }
+        }
+        
+        this->_cv.notify_all();
+        
+        for( auto & t: this->_workers )
+        {
+            t.join();
+        }
+        
+        this->_monitor.join();
+        
+        for( const auto & p: this->_jobs )
+        {
+            this->release( p.second );
+            
+            delete p.second;
+        }
+    }
+    
+    void JobScheduler::IMPL::work( size_t worker )
+    {
+        CandidateBatch batch;
+        Job          * job;
+        size_t         i;
+        bool           more;
+        
+        while( true )
+        {
+            {
+                std::unique_lock< std::mutex > l( this->_mtx );
+                
+                job = nullptr;
+                
+                this->_cv.wait_for
+                (
+                    l,
+                    std::chrono::milliseconds( 100 ),
+                    [ & ]
+                    {
+                        return this->_stopping || ( worker < this->_controller.activeWorkers() && ( job = this->pick() ) != nullptr );
+                    }
+                );
+                
+                if( this->_stopping )
+                {
+                    break;
+                }
+                
+                if( job == nullptr )
+                {
+                    continue;
+                }
+                
+                this->_virtualTime = job->pass;
+                job->pass         += JobSchedulerStride / job->spec.priority;
+                
+                job->inflight++;
+            }
+            
+            more = job->source->next( batch, JobSchedulerBatchSize );
+            
+            for( i = 0; more && i < batch.count(); i++ )
+            {
+                if( job->state == JobStateFound || job->state == JobStateCancelled )
+                {
+                    break;
+                }
+                
+                if( job->expand == false )
+                {
+                    this->tryPassword( job, batch.candidate( i ), batch.length( i ) );
+                    
+                    continue;
+                }
+                
+                for( const auto & p: PasswordVariants::expand( std::string( batch.candidate( i ), batch.length( i ) ), job->spec.maxCharsForCaseVariants, job->spec.maxCharsForCommonSubstitutions ) )
+                {
+                    if( this->tryPassword( job, p.c_str(), p.length() ) )
+                    {
+                        break;
+                    }
+                }
+            }
+            
+            {
+                std::lock_guard< std::mutex > l( this->_mtx );
+                
+                job->inflight--;
+                job->exhausted = job->exhausted || more == false;
+                
+                if( job->exhausted && job->inflight == 0 && job->state == JobStateRunning )
+                {
+                    job->state = JobStateExhausted;
+                    
+                    this->log( "job " + std::to_string( job->id ) + " exhausted its word list" );
+                }
+                
+                this->release( job );
+            }
+            
+            this->_cv.notify_all();
+        }
+    }
+    
+    void JobScheduler::IMPL::monitor( void )
+    {
+        unsigned long processed;
+        
+        while( true )
+        {
+            {
+                std::unique_lock< std::mutex > l( this->_mtx );
+                
+                this->_cv.wait_for( l, std::chrono::seconds( 1 ), [ this ]{ return this->_stopping; } );
+                
+                if( this->_stopping )
+                {
+                    break;
+                }
+                
+                processed            = this->_processed;
+                this->_rate          = processed - this->_lastProcessed;
+                this->_lastProcessed = processed;
+                
+                for( const auto & p: this->_jobs )
+                {
+                    Job * job = p.second;
+                    
+                    job->rate          = job->processed - job->lastProcessed;
+                    job->lastProcessed = job->processed;
+                    
+                    if( job->source != nullptr )
+                    {
+                        job->progress = std::min( job->source->progress(), 1.0 );
+                    }
+                }
+            }
+            
+            this->_controller.update( processed );
+        }
+    }
+    
+    JobScheduler::IMPL::Job * JobScheduler::IMPL::pick( void )
+    {
+        Job * job;
+        
+        job = nullptr;
+        
+        for( const auto & p: this->_jobs )
+        {
+            if( p.second->state != JobStateRunning || p.second->exhausted )
+            {
+                continue;
+            }
+            
+            if( job == nullptr || p.second->pass < job->pass )
+            {
+                job = p.second;
+            }
+        }
+        
+        return job;
+    }
+    
+    bool JobScheduler::IMPL::tryPassword( Job * job, const char * password, size_t length )
+    {
+        job->processed++;
+        
+        this->_processed++;
+        
+        if( this->unlock( job, password, length ) == false )
+        {
+            return false;
+        }
+        
+        {
+            std::lock_guard< std::mutex > l( this->_mtx );
+            
+            if( job->state == JobStateFound )
+            {
+                return true;
+            }
+            
+            job->state    = JobStateFound;
+            job->password = std::string( password, length );
+            job->progress = 1.0;
+            
+            this->log( "job " + std::to_string( job->id ) + " found the password" );
+        }
+        
+        return true;
+    }
+    
+    bool JobScheduler::IMPL::unlock( Job * job, const char * password, size_t length )
+    {
+        if( job->verifier != nullptr )
+        {
+            return job->verifier->verify( password, length );
+        }
+        
+        std::lock_guard< std::mutex > l( job->verification );
+        
+        if( SecKeychainUnlock( job->keychain, static_cast< UInt32 >( length ), password, TRUE ) != noErr )
+        {
+            return false;
+        }
+        
+        SecKeychainLock( job->keychain );
+        
+        return SecKeychainUnlock( job->keychain, static_cast< UInt32 >( length ), password, TRUE ) == noErr;
+    }
+    
+    void JobScheduler::IMPL::release( Job * job )
+    {
+        if( job->inflight > 0 || job->state == JobStateRunning || job->state == JobStatePaused )
+        {
+            return;
+        }
+        
+        if( job->source != nullptr )
+        {
+            job->progress = ( job->state == JobStateCancelled ) ? std::min( job->source->progress(), 1.0 ) : 1.0;
+        }
+        
+        delete job->source;
+        delete job->wordList;
+        delete job->verifier;
+        delete job->target;
+        
+        job->source   = nullptr;
+        job->wordList = nullptr;
+        job->verifier = nullptr;
+        job->target   = nullptr;
+        
+        if( job->keychain != nullptr )
+        {
+            CFRelease( job->keychain );
+            
+            job->keychain = nullptr;
+        }
+    }
+    
+    void JobScheduler::IMPL::log( const std::string & message )
+    {
+        if( this->_log != nullptr )
+        {
+            this->_log( message );
+        }
+    }
+    
+    JobScheduler::JobInfo JobScheduler::IMPL::info( const Job * job )
+    {
+        JobInfo info;
+        
+        info.id        = job->id;
+        info.spec      = job->spec;
+        info.state     = job->state;
+        info.processed = job->processed;
+        info.rate      = job->rate;
+        info.progress  = job->progress;
+        info.password  = job->password;
+        
+        return info;
+    }
+}
@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      JobScheduler.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_JOB_SCHEDULER_HPP
+#define XS_JOB_SCHEDULER_HPP
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+namespace XS
+{
+    /*!
+     * Runs several cracking jobs on one shared, persistent pool of workers.
+     * 
+     * Workers take one batch at a time from the job with the lowest pass
+     * value (stride scheduling), so each runnable job gets a share of the
+     * pool proportional to its priority, and jobs with the same priority
+     * get the same share. Jobs can be paused, resumed and reprioritized at
+     * any time; the change applies from the next batch.
+     * The number of active workers is tuned by a ConcurrencyController
+     * against the total throughput of all jobs.
+     */
+    class JobScheduler
+    {
+        public:
+            
+            enum JobState: unsigned int
+            {
+                JobStateRunning,
+                JobStatePaused,
+                JobStateFound,
+                JobStateExhausted,
+                JobStateCancelled
+            };
+            
+            struct JobSpec
+            {
+                std::string  keychain;
+                std::string  wordList;
+                unsigned int priority;
+                size_t       maxCharsForCaseVariants;
+                size_t       maxCharsForCommonSubstitutions;
+            };
+            
+            struct JobInfo
+            {
+                uint64_t      id;
+                JobSpec       spec;
+                JobState      state;
+                unsigned long processed;
+                unsigned long rate;
+                double        progress;
+                std::string   password;
+            };
+            
+            static const unsigned int DefaultPriority = 10;
+            static const unsigned int MaxPriority     = 1000;
+            
+            JobScheduler( size_t maxWorkers, bool adaptive );
+            ~JobScheduler( void );
+            
+            JobScheduler( const JobScheduler & o )      = delete;
+            JobScheduler( JobScheduler && o )           = delete;
+            JobScheduler & operator =( JobScheduler o ) = delete;
+            
+            friend void swap( JobScheduler & o1, JobScheduler & o2 );
+            
+            static std::string stateName( JobState state );
+            
+            size_t                 maxWorkers( void )    const;
+            size_t                 activeWorkers( void ) const;
+            unsigned long          rate( void )          const;
+            std::vector< JobInfo > jobs( void )          const;
+            bool                   job( uint64_t id, JobInfo & info ) const;
+            
+            uint64_t submit( const JobSpec & spec );
+            bool     pause( uint64_t id );
+            bool     resume( uint64_t id );
+            bool     priority( uint64_t id, unsigned int priority );
+            bool     cancel( uint64_t id );
+            void     logger( const std::function< void( const std::string & ) > & log );
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_JOB_SCHEDULER_HPP */
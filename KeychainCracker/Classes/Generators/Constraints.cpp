@@ -0,0 +1,470 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        Constraints.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "Constraints.hpp"
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <cstring>
+
+namespace XS
+{
+    static const unsigned int ConstraintsAllClasses = Constraints::ClassLower | Constraints::ClassUpper | Constraints::ClassDigit | Constraints::ClassSymbol | Constraints::ClassOther;
+    
+    static std::string ConstraintsClassLetters( unsigned int classes );
+    
+    class Constraints::IMPL
+    {
+        public:
+            
+            struct Position
+            {
+                unsigned int classes;
+                std::string  literal;
+            };
+            
+            IMPL( void );
+            
+            static std::vector< std::string > split( const std::string & s );
+            static bool                       equals( const std::string & s, const char * c, size_t bytes );
+            
+            size_t                     _minLength;
+            size_t                     _maxLength;
+            unsigned int               _required;
+            unsigned int               _forbidden;
+            std::string                _prefix;
+            std::string                _suffix;
+            std::string                _pattern;
+            std::vector< std::string > _prefixChars;
+            std::vector< std::string > _suffixChars;
+            std::vector< Position >    _positions;
+    };
+    
+    Constraints::Constraints( void ):
+        impl( new IMPL() )
+    {}
+    
+    Constraints::Constraints( const Constraints & o ):
+        impl( new IMPL( *( o.impl ) ) )
+    {}
+    
+    Constraints::Constraints( Constraints && o ):
+        impl( new IMPL() )
+    {
+        swap( *( this ), o );
+    }
+    
+    Constraints::~Constraints( void )
+    {
+        delete this->impl;
+    }
+    
+    Constraints & Constraints::operator =( Constraints o )
+    {
+        swap( *( this ), o );
+        
+        return *( this );
+    }
+    
+    void swap( Constraints & o1, Constraints & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    unsigned int Constraints::classes( const std::string & letters )
+    {
+        unsigned int classes;
+        
+        classes = ClassNone;
+        
+        for( char c: letters )
+        {
+            switch( c )
+            {
+                case 'l': classes |= ClassLower;  break;
+                case 'u': classes |= ClassUpper;  break;
+                case 'd': classes |= ClassDigit;  break;
+                case 's': classes |= ClassSymbol; break;
+                case 'o': classes |= ClassOther;  break;
+                case 'a': classes |= ClassLower | ClassUpper | ClassDigit | ClassSymbol; break;
+                default:  throw std::runtime_error( std::string( "Unknown character class " ) + c );
+            }
+        }
+        
+        return classes;
+    }
+    
+    unsigned int Constraints::classOf( const char * c, size_t bytes )
+    {
+        unsigned char u;
+        
+        if( bytes != 1 )
+        {
+            return ClassOther;
+        }
+        
+        u = static_cast< unsigned char >( c[ 0 ] );
+        
+        if( u >= 'a' && u <= 'z' )
+        {
+            return ClassLower;
+        }
+        
+        if( u >= 'A' && u <= 'Z' )
+        {
+            return ClassUpper;
+        }
+        
+        if( u >= '0' && u <= '9' )
+        {
+            return ClassDigit;
+        }
+        
+        return ( u >= 0x20 && u < 0x7F ) ? ClassSymbol : ClassOther;
+    }
+    
+    size_t Constraints::characterBytes( const char * c, size_t bytes )
+    {
+        unsigned char u;
+        size_t        n;
+        size_t        i;
+        
+        u = static_cast< unsigned char >( c[ 0 ] );
+        
+        if( u < 0xC0 || u >= 0xF8 )
+        {
+            return 1;
+        }
+        
+        n = ( u >= 0xF0 ) ? 4 : ( ( u >= 0xE0 ) ? 3 : 2 );
+        
+        if( n > bytes )
+        {
+            return 1;
+        }
+        
+        for( i = 1; i < n; i++ )
+        {
+            if( ( static_cast< unsigned char >( c[ i ] ) & 0xC0 ) != 0x80 )
+            {
+                return 1;
+            }
+        }
+        
+        return n;
+    }
+    
+    size_t Constraints::characterLength( const char * s, size_t bytes )
+    {
+        size_t length;
+        size_t n;
+        
+        for( length = 0; bytes > 0; length++ )
+        {
+            n      = characterBytes( s, bytes );
+            s     += n;
+            bytes -= n;
+        }
+        
+        return length;
+    }
+    
+    bool Constraints::empty( void ) const
+    {
+        return this->impl->_minLength == 0
+            && this->impl->_maxLength == std::numeric_limits< size_t >::max()
+            && this->impl->_required  == ClassNone
+            && this->impl->_forbidden == ClassNone
+            && this->impl->_prefix.empty()
+            && this->impl->_suffix.empty()
+            && this->impl->_pattern.empty();
+    }
+    
+    size_t Constraints::minLength( void ) const
+    {
+        return this->impl->_minLength;
+    }
+    
+    size_t Constraints::maxLength( void ) const
+    {
+        return this->impl->_maxLength;
+    }
+    
+    unsigned int Constraints::required( void ) const
+    {
+        return this->impl->_required;
+    }
+    
+    unsigned int Constraints::forbidden( void ) const
+    {
+        return this->impl->_forbidden;
+    }
+    
+    std::string Constraints::prefix( void ) const
+    {
+        return this->impl->_prefix;
+    }
+    
+    std::string Constraints::suffix( void ) const
+    {
+        return this->impl->_suffix;
+    }
+    
+    std::string Constraints::pattern( void ) const
+    {
+        return this->impl->_pattern;
+    }
+    
+    std::string Constraints::description( void ) const
+    {
+        std::string s;
+        
+        if( this->impl->_minLength > 0 || this->impl->_maxLength != std::numeric_limits< size_t >::max() )
+        {
+            s += ", length " + std::to_string( this->impl->_minLength ) + "-";
+            s += ( this->impl->_maxLength != std::numeric_limits< size_t >::max() ) ? std::to_string( this->impl->_maxLength ) : "";
+        }
+        
+        if( this->impl->_prefix.length() > 0 )
+        {
+            s += ", prefix \"" + this->impl->_prefix + "\"";
+        }
+        
+        if( this->impl->_suffix.length() > 0 )
+        {
+            s += ", suffix \"" + this->impl->_suffix + "\"";
+        }
+        
+        if( this->impl->_pattern.length() > 0 )
+        {
+            s += ", pattern " + this->impl->_pattern;
+        }
+        
+        if( this->impl->_required != ClassNone )
+        {
+            s += ", requires " + ConstraintsClassLetters( this->impl->_required );
+        }
+        
+        if( this->impl->_forbidden != ClassNone )
+        {
+            s += ", forbids " + ConstraintsClassLetters( this->impl->_forbidden );
+        }
+        
+        return ( s.length() > 0 ) ? s.substr( 2 ) : "none";
+    }
+    
+    void Constraints::length( size_t minLength, size_t maxLength )
+    {
+        if( minLength > maxLength )
+        {
+            throw std::runtime_error( "Invalid length range" );
+        }
+        
+        this->impl->_minLength = minLength;
+        this->impl->_maxLength = maxLength;
+    }
+    
+    void Constraints::required( unsigned int classes )
+    {
+        this->impl->_required = classes & ConstraintsAllClasses;
+    }
+    
+    void Constraints::forbidden( unsigned int classes )
+    {
+        this->impl->_forbidden = classes & ConstraintsAllClasses;
+    }
+    
+    void Constraints::prefix( const std::string & value )
+    {
+        this->impl->_prefix      = value;
+        this->impl->_prefixChars = IMPL::split( value );
+    }
+    
+    void Constraints::suffix( const std::string & value )
+    {
+        this->impl->_suffix      = value;
+        this->impl->_suffixChars = IMPL::split( value );
+    }
+    
+    void Constraints::pattern( const std::string & value )
+    {
+        std::vector< IMPL::Position > positions;
+        size_t                        i;
+        size_t                        n;
+        
+        for( i = 0; i < value.length(); i += n )
+        {
+            n = characterBytes( value.data() + i, value.length() - i );
+            
+            if( value[ i ] != '?' )
+            {
+                positions.push_back( { ClassNone, value.substr( i, n ) } );
+                
+                continue;
+            }
+            
+            if( i + 1 >= value.length() )
+            {
+                throw std::runtime_error( "Incomplete pattern placeholder in " + value );
+            }
+            
+            n = 2;
+            
+            switch( value[ i + 1 ] )
+            {
+                case '.': positions.push_back( { ConstraintsAllClasses, "" } );   break;
+                case '?': positions.push_back( { ClassNone,             "?" } );  break;
+                default:  positions.push_back( { classes( value.substr( i + 1, 1 ) ), "" } ); break;
+            }
+        }
+        
+        this->impl->_pattern   = value;
+        this->impl->_positions = positions;
+    }
+    
+    bool Constraints::allowsLength( size_t length ) const
+    {
+        return length >= this->impl->_minLength
+            && length <= this->impl->_maxLength
+            && length >= this->impl->_prefixChars.size()
+            && length >= this->impl->_suffixChars.size();
+    }
+    
+    bool Constraints::allows( size_t position, size_t length, const char * c, size_t bytes ) const
+    {
+        size_t s;
+        
+        if( ( classOf( c, bytes ) & this->impl->_forbidden ) != 0 )
+        {
+            return false;
+        }
+        
+        if( position < this->impl->_prefixChars.size() && IMPL::equals( this->impl->_prefixChars[ position ], c, bytes ) == false )
+        {
+            return false;
+        }
+        
+        s = this->impl->_suffixChars.size();
+        
+        if( s > 0 && length >= s && position >= length - s && IMPL::equals( this->impl->_suffixChars[ position - ( length - s ) ], c, bytes ) == false )
+        {
+            return false;
+        }
+        
+        if( position < this->impl->_positions.size() )
+        {
+            const IMPL::Position & p = this->impl->_positions[ position ];
+            
+            if( p.literal.length() > 0 )
+            {
+                return IMPL::equals( p.literal, c, bytes );
+            }
+            
+            return ( classOf( c, bytes ) & p.classes ) != 0;
+        }
+        
+        return true;
+    }
+    
+    bool Constraints::accepts( const char * candidate, size_t bytes ) const
+    {
+        size_t       length;
+        size_t       position;
+        size_t       n;
+        unsigned int found;
+        
+        length = characterLength( candidate, bytes );
+        found  = ClassNone;
+        
+        if( this->allowsLength( length ) == false )
+        {
+            return false;
+        }
+        
+        for( position = 0; position < length; position++ )
+        {
+            n = characterBytes( candidate, bytes );
+            
+            if( this->allows( position, length, candidate, n ) == false )
+            {
+                return false;
+            }
+            
+            found     |= classOf( candidate, n );
+            candidate += n;
+            bytes     -= n;
+        }
+        
+        return ( this->impl->_required & ~found ) == 0;
+    }
+    
+    Constraints::IMPL::IMPL( void ):
+        _minLength( 0 ),
+        _maxLength( std::numeric_limits< size_t >::max() ),
+        _required(  ClassNone ),
+        _forbidden( ClassNone )
+    {}
+    
+    std::vector< std::string > Constraints::IMPL::split( const std::string & s )
+    {
+        std::vector< std::string > chars;
+        size_t                     i;
+        size_t                     n;
+        
+        for( i = 0; i < s.length(); i += n )
+        {
+            n = characterBytes( s.data() + i, s.length() - i );
+            
+            chars.push_back( s.substr( i, n ) );
+        }
+        
+        return chars;
+    }
+    
+    bool Constraints::IMPL::equals( const std::string & s, const char * c, size_t bytes )
+    {
+        return s.length() == bytes && memcmp( s.data(), c, bytes ) == 0;
+    }
+    
+    static std::string ConstraintsClassLetters( unsigned int classes )
+    {
+        std::string s;
+        
+        s += ( classes & Constraints::ClassLower )  ? "l" : "";
+        s += ( classes & Constraints::ClassUpper )  ? "u" : "";
+        s += ( classes & Constraints::ClassDigit )  ? "d" : "";
+        s += ( classes & Constraints::ClassSymbol ) ? "s" : "";
+        s += ( classes & Constraints::ClassOther )  ? "o" : "";
+        
+        return s;
+    }
+}
@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      Constraints.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_CONSTRAINTS_HPP
+#define XS_CONSTRAINTS_HPP
+
+#include <string>
+#include <cstddef>
+
+namespace XS
+{
+    /*!
+     * What is known about a password: a length range, character classes it
+     * must or must not contain, a known prefix or suffix, and a positional
+     * pattern for its first characters.
+     * 
+     * The pattern uses the placeholders of Mask (?l ?u ?d ?s ?a ??), plus
+     * ?. for any character. Lengths and positions count UTF-8 characters,
+     * not bytes.
+     * 
+     * Generators ask allows() for each character they are about to place,
+     * so branches that cannot lead to an acceptable password are never
+     * enumerated. accepts() checks a complete candidate.
+     */
+    class Constraints
+    {
+        public:
+            
+            enum Class: unsigned int
+            {
+                ClassNone   = 0,
+                ClassLower  = 1 << 0,
+                ClassUpper  = 1 << 1,
+                ClassDigit  = 1 << 2,
+                ClassSymbol = 1 << 3,
+                ClassOther  = 1 << 4
+            };
+            
+            Constraints( void );
+            Constraints( const Constraints & o );
+            Constraints( Constraints && o );
+            ~Constraints( void );
+            
+            Constraints & operator =( Constraints o );
+            
+            friend void swap( Constraints & o1, Constraints & o2 );
+            
+            static unsigned int classes( const std::string & letters );
+            static unsigned int classOf( const char * c, size_t bytes );
+            static size_t       characterBytes( const char * c, size_t bytes );
+            static size_t       characterLength( const char * s, size_t bytes );
+            
+            bool         empty( void )      const;
+            size_t       minLength( void )  const;
+            size_t       maxLength( void )  const;
+            unsigned int required( void )   const;
+            unsigned int forbidden( void )  const;
+            std::string  prefix( void )     const;
+            std::string  suffix( void )     const;
+            std::string  pattern( void )    const;
+            std::string  description( void ) const;
+            
+            void length( size_t minLength, size_t maxLength );
+            void required( unsigned int classes );
+            void forbidden( unsigned int classes );
+            void prefix( const std::string & value );
+            void suffix( const std::string & value );
+            void pattern( const std::string & value );
+            
+            bool allowsLength( size_t length ) const;
+            bool allows( size_t position, size_t length, const char * c, size_t bytes ) const;
+            bool accepts( const char * candidate, size_t bytes ) const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_CONSTRAINTS_HPP */
@@ -0,0 +1,346 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        HybridSource.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "HybridSource.hpp"
+#include "CompiledWordList.hpp"
+#include "Mask.hpp"
+#include "Constraints.hpp"
+#include <vector>
+#include <map>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cstring>
+
+namespace XS
+{
+    class HybridSource::IMPL
+    {
+        public:
+            
+            struct Entry
+            {
+                size_t       word;
+                uint64_t     first;
+                const Mask * mask;
+            };
+            
+            IMPL( const CompiledWordList * list, const std::list< std::string > & words, const std::string & mask, Mode mode, const Constraints * constraints );
+            
+            size_t        words( void ) const;
+            const char  * word( size_t index, size_t & length ) const;
+            char        * load( size_t index, std::vector< char > & buffer ) const;
+            const Entry & entry( uint64_t index ) const;
+            void          restrict( const Constraints & constraints );
+            
+            const CompiledWordList                                               * _list;
+            std::vector< std::string >                                             _words;
+            Mask                                                                   _mask;
+            Mode                                                                   _mode;
+            uint64_t                                                               _keyspace;
+            std::atomic< uint64_t >                                                _cursor;
+            bool                                                                   _constrained;
+            std::map< std::pair< size_t, unsigned int >, std::unique_ptr< Mask > > _masks;
+            std::vector< Entry >                                                   _entries;
+    };
+    
+    HybridSource::HybridSource( const CompiledWordList & list, const std::string & mask, Mode mode, const Constraints * constraints ):
+        impl( new IMPL( &list, {}, mask, mode, constraints ) )
+    {}
+    
+    HybridSource::HybridSource( const std::list< std::string > & words, const std::string & mask, Mode mode, const Constraints * constraints ):
+        impl( new IMPL( nullptr, words, mask, mode, constraints ) )
+    {}
+    
+    HybridSource::~HybridSource( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( HybridSource & o1, HybridSource & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    void HybridSource::restart( void )
+    {
+        this->impl->_cursor = 0;
+    }
+    
+    bool HybridSource::next( CandidateBatch & batch, size_t max )
+    {
+        std::vector< char >   buffer;
+        std::vector< size_t > digits;
+        uint64_t              begin;
+        uint64_t              end;
+        uint64_t              i;
+        uint64_t              masks;
+        uint64_t              limit;
+        char                * mask;
+        const IMPL::Entry   * entry;
+        
+        batch.clear();
+        
+        begin = this->impl->_cursor.fetch_add( max );
+        end   = std::min( begin + max, this->impl->_keyspace );
+        masks = this->impl->_mask.count();
+        mask  = nullptr;
+        entry = nullptr;
+        limit = 0;
+        
+        for( i = begin; i < end; i++ )
+        {
+            if( this->impl->_constrained )
+            {
+                if( i == begin || i == limit )
+                {
+                    entry = &( this->impl->entry( i ) );
+                    limit = entry->first + entry->mask->count();
+                    mask  = this->impl->load( entry->word, buffer );
+                    
+                    entry->mask->seek( i - entry->first, digits, mask );
+                }
+                else
+                {
+                    entry->mask->increment( digits, mask );
+                }
+            }
+            else if( i == begin || i % masks == 0 )
+            {
+                mask = this->impl->load( static_cast< size_t >( i / masks ), buffer );
+                
+                this->impl->_mask.seek( i % masks, digits, mask );
+            }
+            else
+            {
+                this->impl->_mask.increment( digits, mask );
+            }
+            
+            batch.add( buffer.data(), buffer.size() );
+        }
+        
+        return batch.count() > 0;
+    }
+    
+    size_t HybridSource::count( void ) const
+    {
+        return static_cast< size_t >( this->impl->_keyspace );
+    }
+    
+    double HybridSource::progress( void ) const
+    {
+        if( this->impl->_keyspace == 0 )
+        {
+            return 1.0;
+        }
+        
+        return std::min( static_cast< double >( this->impl->_cursor ) / static_cast< double >( this->impl->_keyspace ), 1.0 );
+    }
+    
+    uint64_t HybridSource::keyspace( void ) const
+    {
+        return this->impl->_keyspace;
+    }
+    
+    std::string HybridSource::candidate( uint64_t index ) const
+    {
+        std::vector< char >   buffer;
+        std::vector< size_t > digits;
+        uint64_t              masks;
+        
+        if( index >= this->impl->_keyspace )
+        {
+            throw std::out_of_range( "Hybrid candidate index is out of range" );
+        }
+        
+        if( this->impl->_constrained )
+        {
+            const IMPL::Entry & entry = this->impl->entry( index );
+            
+            entry.mask->seek( index - entry.first, digits, this->impl->load( entry.word, buffer ) );
+            
+            return std::string( buffer.data(), buffer.size() );
+        }
+        
+        masks = this->impl->_mask.count();
+        
+        this->impl->_mask.seek( index % masks, digits, this->impl->load( static_cast< size_t >( index / masks ), buffer ) );
+        
+        return std::string( buffer.data(), buffer.size() );
+    }
+    
+    HybridSource::IMPL::IMPL( const CompiledWordList * list, const std::list< std::string > & words, const std::string & mask, Mode mode, const Constraints * constraints ):
+        _list(        list ),
+        _words(       words.begin(), words.end() ),
+        _mask(        mask ),
+        _mode(        mode ),
+        _keyspace(    0 ),
+        _cursor(      0 ),
+        _constrained( constraints != nullptr && constraints->empty() == false )
+    {
+        uint64_t n;
+        
+        if( this->_constrained )
+        {
+            this->restrict( *( constraints ) );
+            
+            return;
+        }
+        
+        n = this->words();
+        
+        if( n > 0 && this->_mask.count() > std::numeric_limits< size_t >::max() / n )
+        {
+            throw std::runtime_error( "Hybrid keyspace is too large" );
+        }
+        
+        this->_keyspace = n * this->_mask.count();
+    }
+    
+    size_t HybridSource::IMPL::words( void ) const
+    {
+        return ( this->_list != nullptr ) ? this->_list->count() : this->_words.size();
+    }
+    
+    const char * HybridSource::IMPL::word( size_t index, size_t & length ) const
+    {
+        if( this->_list != nullptr )
+        {
+            length = this->_list->length( index );
+            
+            return this->_list->word( index );
+        }
+        
+        length = this->_words[ index ].length();
+        
+        return this->_words[ index ].data();
+    }
+    
+    char * HybridSource::IMPL::load( size_t index, std::vector< char > & buffer ) const
+    {
+        const char * w;
+        size_t       length;
+        
+        w = this->word( index, length );
+        
+        buffer.resize( length + this->_mask.length() );
+        
+        if( this->_mode == ModePrepend )
+        {
+            memcpy( buffer.data() + this->_mask.length(), w, length );
+            
+            return buffer.data();
+        }
+        
+        memcpy( buffer.data(), w, length );
+        
+        return buffer.data() + length;
+    }
+    
+    const HybridSource::IMPL::Entry & HybridSource::IMPL::entry( uint64_t index ) const
+    {
+        std::vector< Entry >::const_iterator e;
+        
+        e = std::upper_bound
+        (
+            this->_entries.begin(),
+            this->_entries.end(),
+            index,
+            []( uint64_t i, const Entry & o )
+            {
+                return i < o.first;
+            }
+        );
+        
+        return *( e - 1 );
+    }
+    
+    void HybridSource::IMPL::restrict( const Constraints & constraints )
+    {
+        const char * w;
+        size_t       bytes;
+        size_t       length;
+        size_t       offset;
+        size_t       position;
+        size_t       i;
+        size_t       n;
+        size_t       index;
+        unsigned int found;
+        bool         allowed;
+        
+        for( index = 0; index < this->words(); index++ )
+        {
+            w       = this->word( index, bytes );
+            length  = Constraints::characterLength( w, bytes ) + this->_mask.length();
+            offset  = ( this->_mode == ModePrepend ) ? this->_mask.length() : 0;
+            found   = Constraints::ClassNone;
+            allowed = constraints.allowsLength( length );
+            
+            for( i = 0, position = offset; allowed && i < bytes; i += n, position++ )
+            {
+                n        = Constraints::characterBytes( w + i, bytes - i );
+                allowed  = constraints.allows( position, length, w + i, n );
+                found   |= Constraints::classOf( w + i, n );
+            }
+            
+            if( allowed == false )
+            {
+                continue;
+            }
+            
+            found &= constraints.required();
+            
+            std::unique_ptr< Mask > & mask = this->_masks[ std::make_pair( length, found ) ];
+            
+            if( mask == nullptr )
+            {
+                mask.reset( new Mask( this->_mask, constraints, ( this->_mode == ModePrepend ) ? 0 : length - this->_mask.length(), length, found ) );
+            }
+            
+            if( mask->count() == 0 )
+            {
+                continue;
+            }
+            
+            if( this->_keyspace > std::numeric_limits< size_t >::max() - mask->count() )
+            {
+                throw std::runtime_error( "Hybrid keyspace is too large" );
+            }
+            
+            this->_entries.push_back( { index, this->_keyspace, mask.get() } );
+            
+            this->_keyspace += mask->count();
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      HybridSource.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_HYBRID_SOURCE_HPP
+#define XS_HYBRID_SOURCE_HPP
+
+#include "CandidateSource.hpp"
+#include <string>
+#include <list>
+#include <cstdint>
+
+namespace XS
+{
+    class CompiledWordList;
+    class Constraints;
+    
+    /*!
+     * Pairs every word of a list with every combination of a Mask, appended
+     * or prepended ("summer" + "?d?d?d?d?s" gives "summer2017!").
+     * 
+     * Candidate i is word ( i / masks ) combined with mask ( i % masks ).
+     * Each word is copied once into a working buffer, then only the mask
+     * characters that change from one candidate to the next are rewritten.
+     * 
+     * With constraints, words that cannot be part of an acceptable candidate
+     * are left out, and every other word gets the mask restricted to what
+     * can follow or precede it, so the keyspace only holds candidates that
+     * satisfy the constraints.
+     */
+    class HybridSource: public CandidateSource
+    {
+        public:
+            
+            enum Mode: unsigned int
+            {
+                ModeAppend,
+                ModePrepend
+            };
+            
+            HybridSource( const CompiledWordList & list, const std::string & mask, Mode mode, const Constraints * constraints = nullptr );
+            HybridSource( const std::list< std::string > & words, const std::string & mask, Mode mode, const Constraints * constraints = nullptr );
+            ~HybridSource( void ) override;
+            
+            HybridSource( const HybridSource & o )      = delete;
+            HybridSource( HybridSource && o )           = delete;
+            HybridSource & operator =( HybridSource o ) = delete;
+            
+            friend void swap( HybridSource & o1, HybridSource & o2 );
+            
+            void   restart( void )                            override;
+            bool   next( CandidateBatch & batch, size_t max ) override;
+            size_t count( void )                        const override;
+            double progress( void )                     const override;
+            
+            uint64_t    keyspace( void )             const;
+            std::string candidate( uint64_t index )  const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_HYBRID_SOURCE_HPP */
@@ -0,0 +1,322 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        MarkovModel.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "MarkovModel.hpp"
+#include "CompiledWordList.hpp"
+#include "WordListStream.hpp"
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace XS
+{
+    static const char     MarkovModelMagic[ 4 ] = { 'K', 'C', 'M', 'K' };
+    static const uint32_t MarkovModelVersion    = 1;
+    static const double   MarkovModelSmoothing  = 0.01;
+    
+    struct MarkovModelHeader
+    {
+        char     magic[ 4 ];
+        uint32_t version;
+        uint32_t positions;
+        uint32_t alphabet;
+        uint64_t words;
+    };
+    
+    const size_t MarkovModel::Alphabet;
+    const char   MarkovModel::FirstChar;
+    const size_t MarkovModel::LevelsPerBit;
+    
+    class MarkovModel::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & path );
+            
+            static bool    add( const char * word, size_t length, size_t positions, std::vector< uint64_t > & counts );
+            static uint8_t level( uint64_t count, uint64_t total );
+            
+            size_t                 _positions;
+            std::vector< uint8_t > _costs;
+    };
+    
+    MarkovModel::MarkovModel( const std::string & path ):
+        impl( new IMPL( path ) )
+    {}
+    
+    MarkovModel::~MarkovModel( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( MarkovModel & o1, MarkovModel & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    bool MarkovModel::isMarkovModel( const std::string & path )
+    {
+        std::ifstream in( path, std::ios::binary );
+        char          magic[ 4 ];
+        
+        if( in.read( magic, sizeof( magic ) ).gcount() != sizeof( magic ) )
+        {
+            return false;
+        }
+        
+        return memcmp( magic, MarkovModelMagic, sizeof( magic ) ) == 0;
+    }
+    
+    MarkovModel::TrainStatistics MarkovModel::train( const std::string & input, const std::string & output, size_t positions )
+    {
+        TrainStatistics         stats;
+        MarkovModelHeader       header;
+        std::vector< uint64_t > counts;
+        std::vector< uint8_t >  costs;
+        std::ofstream           out;
+        size_t                  table;
+        size_t                  row;
+        size_t                  i;
+        uint64_t                total;
+        
+        if( positions == 0 )
+        {
+            throw std::runtime_error( "A Markov model needs at least one position" );
+        }
+        
+        memset( &stats,  0, sizeof( stats ) );
+        memset( &header, 0, sizeof( header ) );
+        
+        counts.resize( Alphabet + ( positions - 1 ) * Alphabet * Alphabet, 0 );
+        
+        if( CompiledWordList::isCompiledWordList( input ) )
+        {
+            CompiledWordList list( input );
+            
+            for( i = 0; i < list.count(); i++ )
+            {
+                if( IMPL::add( list.word( i ), list.length( i ), positions, counts ) )
+                {
+                    stats.words++;
+                }
+                else
+                {
+                    stats.skipped++;
+                }
+            }
+        }
+        else
+        {
+            WordListStream stream( input );
+            CandidateBatch batch;
+            
+            stream.restart();
+            
+            while( stream.next( batch, 4096 ) )
+            {
+                for( i = 0; i < batch.count(); i++ )
+                {
+                    if( IMPL::add( batch.candidate( i ), batch.length( i ), positions, counts ) )
+                    {
+                        stats.words++;
+                    }
+                    else
+                    {
+                        stats.skipped++;
+                    }
+                }
+            }
+            
+            if( stream.error().length() > 0 )
+            {
+                throw std::runtime_error( stream.error() );
+            }
+        }
+        
+        costs.resize( counts.size() );
+        
+        for( table = 0; table < positions; table++ )
+        {
+            for( row = 0; row < ( ( table == 0 ) ? 1 : Alphabet ); row++ )
+            {
+                size_t base;
+                
+                base  = ( table == 0 ) ? 0 : Alphabet + ( ( table - 1 ) * Alphabet + row ) * Alphabet;
+                total = 0;
+                
+                for( i = 0; i < Alphabet; i++ )
+                {
+                    total += counts[ base + i ];
+                }
+                
+                for( i = 0; i < Alphabet; i++ )
+                {
+                    costs[ base + i ] = IMPL::level( counts[ base + i ], total );
+                }
+            }
+        }
+        
+        memcpy( header.magic, MarkovModelMagic, sizeof( header.magic ) );
+        
+        header.version   = MarkovModelVersion;
+        header.positions = static_cast< uint32_t >( positions );
+        header.alphabet  = static_cast< uint32_t >( Alphabet );
+        header.words     = stats.words;
+        stats.positions  = positions;
+        
+        out.open( output, std::ios::binary | std::ios::trunc );
+        
+        if( out.good() == false )
+        {
+            throw std::runtime_error( std::string( "Cannot create Markov model " ) + output );
+        }
+        
+        out.write( reinterpret_cast< const char * >( &header ), sizeof( header ) );
+        out.write( reinterpret_cast< const char * >( costs.data() ), static_cast< std::streamsize >( costs.size() ) );
+        out.close();
+        
+        if( out.fail() )
+        {
+            throw std::runtime_error( std::string( "Error writing Markov model " ) + output );
+        }
+        
+        return stats;
+    }
+    
+    size_t MarkovModel::positions( void ) const
+    {
+        return this->impl->_positions;
+    }
+    
+    uint8_t MarkovModel::cost( size_t position, size_t previous, size_t c ) const
+    {
+        position = std::min( position, this->impl->_positions - 1 );
+        
+        if( position == 0 )
+        {
+            return this->impl->_costs[ c ];
+        }
+        
+        return this->impl->_costs[ Alphabet + ( ( position - 1 ) * Alphabet + previous ) * Alphabet + c ];
+    }
+    
+    MarkovModel::IMPL::IMPL( const std::string & path ):
+        _positions( 0 )
+    {
+        std::ifstream     in( path, std::ios::binary );
+        MarkovModelHeader header;
+        
+        if( in.good() == false )
+        {
+            throw std::runtime_error( std::string( "Cannot open Markov model " ) + path );
+        }
+        
+        memset( &header, 0, sizeof( header ) );
+        in.read( reinterpret_cast< char * >( &header ), sizeof( header ) );
+        
+        if
+        (
+               in.gcount() != sizeof( header )
+            || memcmp( header.magic, MarkovModelMagic, sizeof( header.magic ) ) != 0
+            || header.version   != MarkovModelVersion
+            || header.alphabet  != Alphabet
+            || header.positions == 0
+        )
+        {
+            throw std::runtime_error( std::string( "Invalid Markov model " ) + path );
+        }
+        
+        this->_positions = header.positions;
+        
+        this->_costs.resize( Alphabet + ( this->_positions - 1 ) * Alphabet * Alphabet );
+        in.read( reinterpret_cast< char * >( this->_costs.data() ), static_cast< std::streamsize >( this->_costs.size() ) );
+        
+        if( static_cast< size_t >( in.gcount() ) != this->_costs.size() )
+        {
+            throw std::runtime_error( std::string( "Invalid Markov model " ) + path );
+        }
+    }
+    
+    bool MarkovModel::IMPL::add( const char * word, size_t length, size_t positions, std::vector< uint64_t > & counts )
+    {
+        size_t i;
+        size_t c;
+        size_t previous;
+        
+        for( i = 0; i < length; i++ )
+        {
+            if( word[ i ] < FirstChar || static_cast< size_t >( word[ i ] - FirstChar ) >= Alphabet )
+            {
+                return false;
+            }
+        }
+        
+        previous = 0;
+        
+        for( i = 0; i < std::min( length, positions ); i++ )
+        {
+            c = static_cast< size_t >( word[ i ] - FirstChar );
+            
+            if( i == 0 )
+            {
+                counts[ c ]++;
+            }
+            else
+            {
+                counts[ Alphabet + ( ( i - 1 ) * Alphabet + previous ) * Alphabet + c ]++;
+            }
+            
+            previous = c;
+        }
+        
+        return length > 0;
+    }
+    
+    uint8_t MarkovModel::IMPL::level( uint64_t count, uint64_t total )
+    {
+        double p;
+        
+        if( total == 0 )
+        {
+            p = 1.0 / static_cast< double >( Alphabet );
+        }
+        else
+        {
+            p = ( static_cast< double >( count ) + MarkovModelSmoothing ) / ( static_cast< double >( total ) + MarkovModelSmoothing * static_cast< double >( Alphabet ) );
+        }
+        
+        return static_cast< uint8_t >( std::min( std::round( -std::log2( p ) * static_cast< double >( LevelsPerBit ) ), 255.0 ) );
+    }
+}
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      MarkovModel.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_MARKOV_MODEL_HPP
+#define XS_MARKOV_MODEL_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace XS
+{
+    /*!
+     * Per-position character statistics trained from a word list.
+     * 
+     * For every position, the model stores the cost of each printable ASCII
+     * character given the previous one (or, for the first position, the
+     * cost of the character itself). Costs are quantized -log2 probabilities,
+     * in half-bits, so the cost of a whole candidate is the sum of the costs
+     * of its characters, and cheaper candidates are more likely.
+     * Positions past the trained ones reuse the last table.
+     */
+    class MarkovModel
+    {
+        public:
+            
+            struct TrainStatistics
+            {
+                size_t words;
+                size_t skipped;
+                size_t positions;
+            };
+            
+            static const size_t  Alphabet     = 95;
+            static const char    FirstChar    = ' ';
+            static const size_t  LevelsPerBit = 2;
+            
+            explicit MarkovModel( const std::string & path );
+            ~MarkovModel( void );
+            
+            MarkovModel( const MarkovModel & o )      = delete;
+            MarkovModel( MarkovModel && o )           = delete;
+            MarkovModel & operator =( MarkovModel o ) = delete;
+            
+            friend void swap( MarkovModel & o1, MarkovModel & o2 );
+            
+            static bool            isMarkovModel( const std::string & path );
+            static TrainStatistics train( const std::string & input, const std::string & output, size_t positions );
+            
+            size_t  positions( void ) const;
+            uint8_t cost( size_t position, size_t previous, size_t c ) const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_MARKOV_MODEL_HPP */
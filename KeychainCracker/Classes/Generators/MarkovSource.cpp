@@ -0,0 +1,386 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        MarkovSource.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "MarkovSource.hpp"
+#include "MarkovModel.hpp"
+#include "Constraints.hpp"
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+
+namespace XS
+{
+    const size_t       MarkovSource::MaxLength;
+    const unsigned int MarkovSource::MaxThreshold;
+    
+    class MarkovSource::IMPL
+    {
+        public:
+            
+            struct Block
+            {
+                uint64_t first;
+                uint64_t count;
+                size_t   cost;
+                size_t   length;
+            };
+            
+            IMPL( const MarkovModel & model, size_t minLength, size_t maxLength, unsigned int threshold, const Constraints * constraints );
+            
+            uint64_t ways( size_t length, size_t position, size_t previous, unsigned int found, size_t budget ) const;
+            bool     allowed( size_t length, size_t position, size_t c ) const;
+            size_t   decode( uint64_t index, char * out ) const;
+            
+            static uint64_t add( uint64_t a, uint64_t b );
+            
+            const MarkovModel                    & _model;
+            size_t                                 _minLength;
+            size_t                                 _maxLength;
+            size_t                                 _threshold;
+            size_t                                 _states;
+            std::vector< unsigned int >            _classes;
+            std::vector< std::vector< bool > >     _allowed;
+            std::vector< std::vector< uint64_t > > _ways;
+            std::vector< Block >                   _blocks;
+            uint64_t                               _keyspace;
+            std::atomic< uint64_t >                _cursor;
+    };
+    
+    MarkovSource::MarkovSource( const MarkovModel & model, size_t minLength, size_t maxLength, unsigned int threshold, const Constraints * constraints ):
+        impl( new IMPL( model, minLength, maxLength, threshold, constraints ) )
+    {}
+    
+    MarkovSource::~MarkovSource( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( MarkovSource & o1, MarkovSource & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    void MarkovSource::restart( void )
+    {
+        this->impl->_cursor = 0;
+    }
+    
+    bool MarkovSource::next( CandidateBatch & batch, size_t max )
+    {
+        char     buffer[ MaxLength ];
+        uint64_t begin;
+        uint64_t end;
+        uint64_t i;
+        
+        batch.clear();
+        
+        begin = this->impl->_cursor.fetch_add( max );
+        end   = std::min( begin + max, this->impl->_keyspace );
+        
+        for( i = begin; i < end; i++ )
+        {
+            batch.add( buffer, this->impl->decode( i, buffer ) );
+        }
+        
+        return batch.count() > 0;
+    }
+    
+    size_t MarkovSource::count( void ) const
+    {
+        return static_cast< size_t >( this->impl->_keyspace );
+    }
+    
+    double MarkovSource::progress( void ) const
+    {
+        if( this->impl->_keyspace == 0 )
+        {
+            return 1.0;
+        }
+        
+        return std::min( static_cast< double >( this->impl->_cursor ) / static_cast< double >( this->impl->_keyspace ), 1.0 );
+    }
+    
+    uint64_t MarkovSource::keyspace( void ) const
+    {
+        return this->impl->_keyspace;
+    }
+    
+    std::string MarkovSource::candidate( uint64_t index ) const
+    {
+        char buffer[ MaxLength ];
+        
+        if( index >= this->impl->_keyspace )
+        {
+            throw std::out_of_range( "Markov candidate index is out of range" );
+        }
+        
+        return std::string( buffer, this->impl->decode( index, buffer ) );
+    }
+    
+    MarkovSource::IMPL::IMPL( const MarkovModel & model, size_t minLength, size_t maxLength, unsigned int threshold, const Constraints * constraints ):
+        _model(     model ),
+        _minLength( std::max( minLength, static_cast< size_t >( 1 ) ) ),
+        _maxLength( maxLength ),
+        _threshold( threshold ),
+        _states(    1 ),
+        _classes(   MarkovModel::Alphabet, 0 ),
+        _keyspace(  0 ),
+        _cursor(    0 )
+    {
+        const size_t alphabet = MarkovModel::Alphabet;
+        const size_t budgets  = this->_threshold + 1;
+        size_t       length;
+        size_t       position;
+        size_t       previous;
+        size_t       c;
+        size_t       b;
+        size_t       cost;
+        unsigned int found;
+        unsigned int next;
+        uint64_t     n;
+        
+        if( this->_maxLength > MaxLength || this->_minLength > this->_maxLength )
+        {
+            throw std::runtime_error( "Invalid Markov length range" );
+        }
+        
+        if( this->_threshold > MaxThreshold )
+        {
+            throw std::runtime_error( "Markov threshold is too large" );
+        }
+        
+        if( constraints != nullptr )
+        {
+            for( unsigned int required = constraints->required(); required != 0; required &= required - 1 )
+            {
+                for( c = 0; c < alphabet; c++ )
+                {
+                    char ch = static_cast< char >( MarkovModel::FirstChar + static_cast< char >( c ) );
+                    
+                    if( ( Constraints::classOf( &ch, 1 ) & required & ~( required - 1 ) ) != 0 )
+                    {
+                        this->_classes[ c ] |= static_cast< unsigned int >( this->_states );
+                    }
+                }
+                
+                this->_states *= 2;
+            }
+        }
+        
+        for( length = this->_minLength; length <= this->_maxLength; length++ )
+        {
+            std::vector< bool > allowed( length * alphabet, true );
+            
+            if( constraints != nullptr && constraints->allowsLength( length ) == false )
+            {
+                this->_allowed.push_back( {} );
+                this->_ways.push_back( {} );
+                
+                continue;
+            }
+            
+            for( position = 0; constraints != nullptr && position < length; position++ )
+            {
+                for( c = 0; c < alphabet; c++ )
+                {
+                    char ch = static_cast< char >( MarkovModel::FirstChar + static_cast< char >( c ) );
+                    
+                    allowed[ position * alphabet + c ] = constraints->allows( position, length, &ch, 1 );
+                }
+            }
+            
+            this->_allowed.push_back( std::move( allowed ) );
+            
+            std::vector< uint64_t > table( ( length - 1 ) * alphabet * this->_states * budgets, 0 );
+            
+            for( position = length - 1; position > 0; position-- )
+            {
+                for( previous = 0; previous < alphabet; previous++ )
+                {
+                    for( found = 0; found < this->_states; found++ )
+                    {
+                        uint64_t * row = table.data() + ( ( ( position - 1 ) * alphabet + previous ) * this->_states + found ) * budgets;
+                        
+                        for( c = 0; c < alphabet; c++ )
+                        {
+                            if( this->allowed( length, position, c ) == false )
+                            {
+                                continue;
+                            }
+                            
+                            cost = this->_model.cost( position, previous, c );
+                            next = found | this->_classes[ c ];
+                            
+                            for( b = cost; b < budgets; b++ )
+                            {
+                                if( position + 1 == length )
+                                {
+                                    n = ( b == cost && next + 1 == this->_states ) ? 1 : 0;
+                                }
+                                else
+                                {
+                                    n = table[ ( ( position * alphabet + c ) * this->_states + next ) * budgets + b - cost ];
+                                }
+                                
+                                row[ b ] = IMPL::add( row[ b ], n );
+                            }
+                        }
+                    }
+                }
+            }
+            
+            this->_ways.push_back( std::move( table ) );
+        }
+        
+        for( b = 0; b < budgets; b++ )
+        {
+            for( length = this->_minLength; length <= this->_maxLength; length++ )
+            {
+                if( this->_allowed[ length - this->_minLength ].empty() )
+                {
+                    continue;
+                }
+                
+                n = 0;
+                
+                for( c = 0; c < alphabet; c++ )
+                {
+                    cost = this->_model.cost( 0, 0, c );
+                    
+                    if( cost <= b && this->allowed( length, 0, c ) )
+                    {
+                        n = IMPL::add( n, this->ways( length, 1, c, this->_classes[ c ], b - cost ) );
+                    }
+                }
+                
+                if( n == 0 )
+                {
+                    continue;
+                }
+                
+                if( n == std::numeric_limits< uint64_t >::max() || IMPL::add( this->_keyspace, n ) == std::numeric_limits< uint64_t >::max() )
+                {
+                    throw std::runtime_error( "Markov keyspace is too large, use a lower threshold" );
+                }
+                
+                this->_blocks.push_back( { this->_keyspace, n, b, length } );
+                
+                this->_keyspace += n;
+            }
+        }
+    }
+    
+    uint64_t MarkovSource::IMPL::ways( size_t length, size_t position, size_t previous, unsigned int found, size_t budget ) const
+    {
+        if( position == length )
+        {
+            return ( budget == 0 && found + 1 == this->_states ) ? 1 : 0;
+        }
+        
+        return this->_ways[ length - this->_minLength ][ ( ( ( position - 1 ) * MarkovModel::Alphabet + previous ) * this->_states + found ) * ( this->_threshold + 1 ) + budget ];
+    }
+    
+    bool MarkovSource::IMPL::allowed( size_t length, size_t position, size_t c ) const
+    {
+        return this->_allowed[ length - this->_minLength ][ position * MarkovModel::Alphabet + c ];
+    }
+    
+    size_t MarkovSource::IMPL::decode( uint64_t index, char * out ) const
+    {
+        std::vector< Block >::const_iterator block;
+        size_t                               position;
+        size_t                               previous;
+        size_t                               budget;
+        size_t                               cost;
+        size_t                               c;
+        unsigned int                         found;
+        uint64_t                             n;
+        
+        block = std::upper_bound
+        (
+            this->_blocks.begin(),
+            this->_blocks.end(),
+            index,
+            []( uint64_t i, const Block & b )
+            {
+                return i < b.first;
+            }
+        )
+        - 1;
+        
+        index   -= block->first;
+        budget   = block->cost;
+        previous = 0;
+        found    = 0;
+        
+        for( position = 0; position < block->length; position++ )
+        {
+            for( c = 0; c < MarkovModel::Alphabet; c++ )
+            {
+                if( this->allowed( block->length, position, c ) == false )
+                {
+                    continue;
+                }
+                
+                cost = this->_model.cost( position, previous, c );
+                
+                if( cost > budget )
+                {
+                    continue;
+                }
+                
+                n = this->ways( block->length, position + 1, c, found | this->_classes[ c ], budget - cost );
+                
+                if( index < n )
+                {
+                    break;
+                }
+                
+                index -= n;
+            }
+            
+            out[ position ] = static_cast< char >( MarkovModel::FirstChar + static_cast< char >( c ) );
+            budget         -= this->_model.cost( position, previous, c );
+            found          |= this->_classes[ c ];
+            previous        = c;
+        }
+        
+        return block->length;
+    }
+    
+    uint64_t MarkovSource::IMPL::add( uint64_t a, uint64_t b )
+    {
+        return ( a > std::numeric_limits< uint64_t >::max() - b ) ? std::numeric_limits< uint64_t >::max() : a + b;
+    }
+}
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      MarkovSource.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_MARKOV_SOURCE_HPP
+#define XS_MARKOV_SOURCE_HPP
+
+#include "CandidateSource.hpp"
+#include <string>
+#include <cstdint>
+
+namespace XS
+{
+    class MarkovModel;
+    class Constraints;
+    
+    /*!
+     * Enumerates every candidate whose MarkovModel cost is at most a given
+     * threshold, cheapest (most likely) costs first.
+     * 
+     * The number of completions of each prefix is precomputed for every
+     * position, previous character and remaining budget, so the keyspace
+     * is index-addressable: candidate( i ) is decoded directly, without
+     * enumerating the candidates before it.
+     * 
+     * With constraints, characters that are not allowed at a position are
+     * left out of the counts, and completions are also counted per set of
+     * required character classes found so far, so the keyspace only holds
+     * acceptable candidates.
+     */
+    class MarkovSource: public CandidateSource
+    {
+        public:
+            
+            static const size_t       MaxLength    = 32;
+            static const unsigned int MaxThreshold = 1024;
+            
+            MarkovSource( const MarkovModel & model, size_t minLength, size_t maxLength, unsigned int threshold, const Constraints * constraints = nullptr );
+            ~MarkovSource( void ) override;
+            
+            MarkovSource( const MarkovSource & o )      = delete;
+            MarkovSource( MarkovSource && o )           = delete;
+            MarkovSource & operator =( MarkovSource o ) = delete;
+            
+            friend void swap( MarkovSource & o1, MarkovSource & o2 );
+            
+            void   restart( void )                            override;
+            bool   next( CandidateBatch & batch, size_t max ) override;
+            size_t count( void )                        const override;
+            double progress( void )                     const override;
+            
+            uint64_t    keyspace( void )            const;
+            std::string candidate( uint64_t index ) const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_MARKOV_SOURCE_HPP */
@@ -0,0 +1,307 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        Mask.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "Mask.hpp"
+#include "Constraints.hpp"
+#include <stdexcept>
+#include <limits>
+
+namespace XS
+{
+    class Mask::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & pattern );
+            IMPL( const IMPL & mask, const Constraints & constraints, size_t offset, size_t length, unsigned int found );
+            
+            static std::string charset( char c );
+            
+            uint64_t     ways( size_t position, unsigned int found ) const;
+            unsigned int classes( const char * out ) const;
+            
+            std::string                _pattern;
+            std::vector< std::string > _positions;
+            uint64_t                   _count;
+            unsigned int               _required;
+            std::vector< uint64_t >    _ways;
+    };
+    
+    Mask::Mask( const std::string & pattern ):
+        impl( new IMPL( pattern ) )
+    {}
+    
+    Mask::Mask( const Mask & mask, const Constraints & constraints, size_t offset, size_t length, unsigned int found ):
+        impl( new IMPL( *( mask.impl ), constraints, offset, length, found ) )
+    {}
+    
+    Mask::~Mask( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( Mask & o1, Mask & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    std::string Mask::pattern( void ) const
+    {
+        return this->impl->_pattern;
+    }
+    
+    size_t Mask::length( void ) const
+    {
+        return this->impl->_positions.size();
+    }
+    
+    uint64_t Mask::count( void ) const
+    {
+        return this->impl->_count;
+    }
+    
+    void Mask::seek( uint64_t index, std::vector< size_t > & digits, char * out ) const
+    {
+        size_t i;
+        size_t n;
+        
+        n = this->impl->_positions.size();
+        
+        digits.resize( n );
+        
+        if( this->impl->_required != 0 )
+        {
+            unsigned int found;
+            uint64_t     ways;
+            
+            for( i = 0, found = 0; i < n; i++ )
+            {
+                const std::string & set = this->impl->_positions[ i ];
+                
+                for( digits[ i ] = 0; digits[ i ] < set.length(); digits[ i ]++ )
+                {
+                    ways = this->impl->ways( i + 1, found | Constraints::classOf( &( set[ digits[ i ] ] ), 1 ) );
+                    
+                    if( index < ways )
+                    {
+                        break;
+                    }
+                    
+                    index -= ways;
+                }
+                
+                out[ i ] = set[ digits[ i ] ];
+                found   |= Constraints::classOf( &( out[ i ] ), 1 );
+            }
+            
+            return;
+        }
+        
+        for( i = n; i > 0; i-- )
+        {
+            const std::string & set = this->impl->_positions[ i - 1 ];
+            
+            digits[ i - 1 ] = static_cast< size_t >( index % set.length() );
+            out[ i - 1 ]    = set[ digits[ i - 1 ] ];
+            index          /= set.length();
+        }
+    }
+    
+    bool Mask::increment( std::vector< size_t > & digits, char * out ) const
+    {
+        size_t i;
+        
+        do
+        {
+            for( i = digits.size(); i > 0; i-- )
+            {
+                const std::string & set = this->impl->_positions[ i - 1 ];
+                
+                if( ++digits[ i - 1 ] < set.length() )
+                {
+                    out[ i - 1 ] = set[ digits[ i - 1 ] ];
+                    
+                    break;
+                }
+                
+                digits[ i - 1 ] = 0;
+                out[ i - 1 ]    = set[ 0 ];
+            }
+            
+            if( i == 0 )
+            {
+                return false;
+            }
+        }
+        while( ( this->impl->_required & ~( this->impl->classes( out ) ) ) != 0 );
+        
+        return true;
+    }
+    
+    Mask::IMPL::IMPL( const std::string & pattern ):
+        _pattern(  pattern ),
+        _count(    1 ),
+        _required( 0 )
+    {
+        size_t i;
+        
+        for( i = 0; i < pattern.length(); i++ )
+        {
+            if( pattern[ i ] != '?' )
+            {
+                this->_positions.push_back( std::string( 1, pattern[ i ] ) );
+            }
+            else if( i + 1 < pattern.length() )
+            {
+                this->_positions.push_back( IMPL::charset( pattern[ ++i ] ) );
+            }
+            else
+            {
+                throw std::runtime_error( "Incomplete mask placeholder in " + pattern );
+            }
+        }
+        
+        for( const auto & set: this->_positions )
+        {
+            if( this->_count > std::numeric_limits< uint64_t >::max() / set.length() )
+            {
+                throw std::runtime_error( "Mask keyspace is too large: " + pattern );
+            }
+            
+            this->_count *= set.length();
+        }
+    }
+    
+    Mask::IMPL::IMPL( const IMPL & mask, const Constraints & constraints, size_t offset, size_t length, unsigned int found ):
+        _pattern(  mask._pattern ),
+        _count(    1 ),
+        _required( constraints.required() & ~found )
+    {
+        size_t       i;
+        unsigned int available;
+        
+        available = found;
+        
+        for( i = 0; i < mask._positions.size(); i++ )
+        {
+            std::string set;
+            
+            for( char c: mask._positions[ i ] )
+            {
+                if( constraints.allows( offset + i, length, &c, 1 ) )
+                {
+                    set       += c;
+                    available |= Constraints::classOf( &c, 1 );
+                }
+            }
+            
+            this->_positions.push_back( set );
+            
+            this->_count *= set.length();
+        }
+        
+        if( ( constraints.required() & ~available ) != 0 )
+        {
+            this->_count = 0;
+        }
+        
+        if( this->_count == 0 || this->_required == 0 )
+        {
+            return;
+        }
+        
+        this->_ways.resize( ( this->_positions.size() + 1 ) * ( this->_required + 1 ), 0 );
+        
+        for( i = this->_positions.size() + 1; i > 0; i-- )
+        {
+            for( unsigned int f = 0; f <= this->_required; f++ )
+            {
+                uint64_t & ways = this->_ways[ ( i - 1 ) * ( this->_required + 1 ) + f ];
+                
+                if( ( f & ~this->_required ) != 0 )
+                {
+                    continue;
+                }
+                
+                if( i - 1 == this->_positions.size() )
+                {
+                    ways = ( f == this->_required ) ? 1 : 0;
+                    
+                    continue;
+                }
+                
+                for( char c: this->_positions[ i - 1 ] )
+                {
+                    ways += this->ways( i, f | Constraints::classOf( &c, 1 ) );
+                }
+            }
+        }
+        
+        this->_count = this->ways( 0, 0 );
+    }
+    
+    uint64_t Mask::IMPL::ways( size_t position, unsigned int found ) const
+    {
+        return this->_ways[ position * ( this->_required + 1 ) + ( found & this->_required ) ];
+    }
+    
+    unsigned int Mask::IMPL::classes( const char * out ) const
+    {
+        unsigned int found;
+        size_t       i;
+        
+        found = 0;
+        
+        for( i = 0; i < this->_positions.size(); i++ )
+        {
+            found |= Constraints::classOf( out + i, 1 );
+        }
+        
+        return found;
+    }
+    
+    std::string Mask::IMPL::charset( char c )
+    {
+        switch( c )
+        {
+            case 'l': return "abcdefghijklmnopqrstuvwxyz";
+            case 'u': return "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+            case 'd': return "0123456789";
+            case 's': return " !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+            case 'a': return IMPL::charset( 'l' ) + IMPL::charset( 'u' ) + IMPL::charset( 'd' ) + IMPL::charset( 's' );
+            case '?': return "?";
+            default:  break;
+        }
+        
+        throw std::runtime_error( std::string( "Unknown mask placeholder ?" ) + c );
+    }
+}
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      Mask.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_MASK_HPP
+#define XS_MASK_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace XS
+{
+    class Constraints;
+    
+    /*!
+     * A fixed-length pattern of character sets, such as "?d?d?d?d?s".
+     * 
+     *     ?l  lowercase ASCII letters
+     *     ?u  uppercase ASCII letters
+     *     ?d  digits
+     *     ?s  printable ASCII symbols, including space
+     *     ?a  all of the above
+     *     ??  a literal question mark
+     * 
+     * Any other character stands for itself.
+     * Every combination has an index in [0, count()), the last position
+     * varying fastest, so a keyspace can be split or resumed at any index.
+     * 
+     * A mask can be restricted to the combinations allowed by Constraints,
+     * once placed in a candidate. Characters that cannot appear at their
+     * position are removed, and when character classes are still required,
+     * combinations are counted per set of classes found so far, so that
+     * count() and seek() only cover combinations that provide them.
+     */
+    class Mask
+    {
+        public:
+            
+            explicit Mask( const std::string & pattern );
+            Mask( const Mask & mask, const Constraints & constraints, size_t offset, size_t length, unsigned int found );
+            ~Mask( void );
+            
+            Mask( const Mask & o )      = delete;
+            Mask( Mask && o )           = delete;
+            Mask & operator =( Mask o ) = delete;
+            
+            friend void swap( Mask & o1, Mask & o2 );
+            
+            std::string pattern( void ) const;
+            size_t      length( void )  const;
+            uint64_t    count( void )   const;
+            
+            void seek( uint64_t index, std::vector< size_t > & digits, char * out ) const;
+            bool increment( std::vector< size_t > & digits, char * out ) const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_MASK_HPP */
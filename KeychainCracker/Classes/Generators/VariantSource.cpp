@@ -0,0 +1,219 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        VariantSource.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "VariantSource.hpp"
+#include "CompiledWordList.hpp"
+#include "PasswordVariants.hpp"
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+
+namespace XS
+{
+    class VariantSource::IMPL
+    {
+        public:
+            
+            IMPL( const CompiledWordList * list, const std::list< std::string > & words, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions );
+            
+            size_t       words( void ) const;
+            const char * word( size_t index, size_t & length ) const;
+            size_t       find( uint64_t index ) const;
+            
+            const CompiledWordList           * _list;
+            std::vector< const std::string * > _words;
+            size_t                             _maxCharsForCaseVariants;
+            size_t                             _maxCharsForCommonSubstitutions;
+            std::vector< uint64_t >            _first;
+            std::atomic< uint64_t >            _cursor;
+    };
+    
+    VariantSource::VariantSource( const CompiledWordList & list, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions ):
+        impl( new IMPL( &list, {}, maxCharsForCaseVariants, maxCharsForCommonSubstitutions ) )
+    {}
+    
+    VariantSource::VariantSource( const std::list< std::string > & words, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions ):
+        impl( new IMPL( nullptr, words, maxCharsForCaseVariants, maxCharsForCommonSubstitutions ) )
+    {}
+    
+    VariantSource::~VariantSource( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( VariantSource & o1, VariantSource & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    void VariantSource::restart( void )
+    {
+        this->impl->_cursor = 0;
+    }
+    
+    bool VariantSource::next( CandidateBatch & batch, size_t max )
+    {
+        std::string  variant;
+        uint64_t     begin;
+        uint64_t     end;
+        uint64_t     i;
+        uint64_t     limit;
+        size_t       index;
+        size_t       length;
+        const char * w;
+        
+        batch.clear();
+        
+        begin  = this->impl->_cursor.fetch_add( max );
+        end    = std::min( begin + max, this->impl->_first.back() );
+        limit  = 0;
+        index  = 0;
+        length = 0;
+        w      = nullptr;
+        
+        for( i = begin; i < end; i++ )
+        {
+            if( i == begin || i == limit )
+            {
+                index = this->impl->find( i );
+                limit = this->impl->_first[ index + 1 ];
+                w     = this->impl->word( index, length );
+            }
+            
+            PasswordVariants::variant( w, length, i - this->impl->_first[ index ], this->impl->_maxCharsForCaseVariants, this->impl->_maxCharsForCommonSubstitutions, variant );
+            batch.add( variant.data(), variant.size() );
+        }
+        
+        return batch.count() > 0;
+    }
+    
+    size_t VariantSource::count( void ) const
+    {
+        return static_cast< size_t >( this->impl->_first.back() );
+    }
+    
+    double VariantSource::progress( void ) const
+    {
+        if( this->impl->_first.back() == 0 )
+        {
+            return 1.0;
+        }
+        
+        return std::min( static_cast< double >( this->impl->_cursor ) / static_cast< double >( this->impl->_first.back() ), 1.0 );
+    }
+    
+    uint64_t VariantSource::keyspace( void ) const
+    {
+        return this->impl->_first.back();
+    }
+    
+    std::string VariantSource::candidate( uint64_t index ) const
+    {
+        std::string  variant;
+        const char * w;
+        size_t       word;
+        size_t       length;
+        
+        if( index >= this->impl->_first.back() )
+        {
+            throw std::out_of_range( "Variant candidate index is out of range" );
+        }
+        
+        word = this->impl->find( index );
+        w    = this->impl->word( word, length );
+        
+        PasswordVariants::variant( w, length, index - this->impl->_first[ word ], this->impl->_maxCharsForCaseVariants, this->impl->_maxCharsForCommonSubstitutions, variant );
+        
+        return variant;
+    }
+    
+    VariantSource::IMPL::IMPL( const CompiledWordList * list, const std::list< std::string > & words, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions ):
+        _list(                           list ),
+        _maxCharsForCaseVariants(        maxCharsForCaseVariants ),
+        _maxCharsForCommonSubstitutions( maxCharsForCommonSubstitutions ),
+        _cursor(                         0 )
+    {
+        const char * w;
+        size_t       length;
+        size_t       i;
+        uint64_t     n;
+        
+        this->_words.reserve( words.size() );
+        
+        for( const auto & word: words )
+        {
+            this->_words.push_back( &word );
+        }
+        
+        this->_first.reserve( this->words() + 1 );
+        this->_first.push_back( 0 );
+        
+        for( i = 0; i < this->words(); i++ )
+        {
+            w = this->word( i, length );
+            n = PasswordVariants::count( w, length, maxCharsForCaseVariants, maxCharsForCommonSubstitutions );
+            
+            if( this->_first.back() > std::numeric_limits< size_t >::max() - n )
+            {
+                throw std::runtime_error( "Variant keyspace is too large" );
+            }
+            
+            this->_first.push_back( this->_first.back() + n );
+        }
+    }
+    
+    size_t VariantSource::IMPL::words( void ) const
+    {
+        return ( this->_list != nullptr ) ? this->_list->count() : this->_words.size();
+    }
+    
+    const char * VariantSource::IMPL::word( size_t index, size_t & length ) const
+    {
+        if( this->_list != nullptr )
+        {
+            length = this->_list->length( index );
+            
+            return this->_list->word( index );
+        }
+        
+        length = this->_words[ index ]->length();
+        
+        return this->_words[ index ]->data();
+    }
+    
+    size_t VariantSource::IMPL::find( uint64_t index ) const
+    {
+        return static_cast< size_t >( std::upper_bound( this->_first.begin(), this->_first.end(), index ) - this->_first.begin() ) - 1;
+    }
+}
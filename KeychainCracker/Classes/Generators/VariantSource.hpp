@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      VariantSource.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_VARIANT_SOURCE_HPP
+#define XS_VARIANT_SOURCE_HPP
+
+#include "CandidateSource.hpp"
+#include <string>
+#include <list>
+#include <cstdint>
+
+namespace XS
+{
+    class CompiledWordList;
+    
+    /*!
+     * The case variants and common substitutions of every word of a list,
+     * addressed by index instead of being generated up front.
+     * 
+     * The source keeps the word list and the running total of the number of
+     * variants of each word. Candidate i is found by a binary search for its
+     * word, then decoded with PasswordVariants::variant, so workers only
+     * claim ranges of indexes and memory does not grow with the keyspace.
+     * The order is the same as expanding each word in turn.
+     * 
+     * The words are referenced, not copied: the compiled word list or the
+     * list of strings must outlive the source.
+     */
+    class VariantSource: public CandidateSource
+    {
+        public:
+            
+            VariantSource( const CompiledWordList & list, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions );
+            VariantSource( const std::list< std::string > & words, size_t maxCharsForCaseVariants, size_t maxCharsForCommonSubstitutions );
+            ~VariantSource( void ) override;
+            
+            VariantSource( const VariantSource & o )      = delete;
+            VariantSource( VariantSource && o )           = delete;
+            VariantSource & operator =( VariantSource o ) = delete;
+            
+            friend void swap( VariantSource & o1, VariantSource & o2 );
+            
+            void   restart( void )                            override;
+            bool   next( CandidateBatch & batch, size_t max ) override;
+            size_t count( void )                        const override;
+            double progress( void )                     const override;
+            
+            uint64_t    keyspace( void )             const;
+            std::string candidate( uint64_t index )  const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_VARIANT_SOURCE_HPP */
@@ -48,6 +48,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property( atomic, readwrite, strong, nullable ) id< KeychainCracker > cracker;
 @property( atomic, readwrite, strong, nullable ) NSTimer             * timer;
 @property( atomic, readwrite, assign           ) NSInteger             numberOfThreads;
+@property( atomic, readwrite, assign           ) BOOL                  adaptiveThreads;
 @property( atomic, readwrite, assign           ) double                progress;
 @property( atomic, readwrite, assign           ) BOOL                  indeterminate;
 @property( atomic, readwrite, assign           ) BOOL                  hasStopped;
@@ -62,6 +63,9 @@ NS_ASSUME_NONNULL_BEGIN
 - ( IBAction )chooseWordList: ( nullable id )sender;
 - ( IBAction )chooseImplementation: ( nullable id )sender;
 - ( void )displayAlertWithTitle: ( NSString * )title message: ( NSString * )message;
+- ( BOOL )applyHybridMask: ( GenericKeychainCracker * )cracker;
+- ( void )applyMarkovSettings: ( GenericKeychainCracker * )cracker;
+- ( BOOL )applyConstraints: ( GenericKeychainCracker * )cracker;
 - ( void )updateUI;
 - ( NSString * )timeRemainingWithSeconds: ( NSUInteger )seconds;
 
@@ -91,6 +95,7 @@ NS_ASSUME_NONNULL_END
     [ [ NSUserDefaults standardUserDefaults ] setBool:    self.commonSubstitutions    forKey: @"CommonSubstitutions" ];
     [ [ NSUserDefaults standardUserDefaults ] setInteger: self.commonSubstitutionsMax forKey: @"CommonSubstitutionsMax" ];
     [ [ NSUserDefaults standardUserDefaults ] setInteger: self.numberOfThreads        forKey: @"NumberOfThreads" ];
+    [ [ NSUserDefaults standardUserDefaults ] setBool:    self.adaptiveThreads        forKey: @"AdaptiveThreads" ];
     [ [ NSUserDefaults standardUserDefaults ] setBool:    self.useCPPImplementation   forKey: @"UseCPPImplementation" ];
     [ [ NSUserDefaults standardUserDefaults ] synchronize ];
 }
@@ -116,6 +121,7 @@ NS_ASSUME_NONNULL_END
     self.commonSubstitutions    = [ [ NSUserDefaults standardUserDefaults ] boolForKey:    @"CommonSubstitutions" ];
     self.commonSubstitutionsMax = [ [ NSUserDefaults standardUserDefaults ] integerForKey: @"CommonSubstitutionsMax" ];
     self.numberOfThreads        = [ [ NSUserDefaults standardUserDefaults ] integerForKey: @"NumberOfThreads" ];
+    self.adaptiveThreads        = ( [ [ NSUserDefaults standardUserDefaults ] objectForKey: @"AdaptiveThreads" ] == nil ) ? YES : [ [ NSUserDefaults standardUserDefaults ] boolForKey: @"AdaptiveThreads" ];
     self.useCPPImplementation   = [ [ NSUserDefaults standardUserDefaults ] boolForKey:    @"UseCPPImplementation" ];
     
     if( self.numberOfThreads <= 0 || self.numberOfThreads > 200 )
@@ -210,20 +216,60 @@ NS_ASSUME_NONNULL_END
         return;
     }
     
-    data      = [ [ NSFileManager defaultManager ] contentsAtPath: self.wordList ];
-    passwords = [ [ [ NSString alloc ] initWithData: data encoding: NSUTF8StringEncoding ] componentsSeparatedByString: @"\n" ];
+    imp = ( self.useCPPImplementation ) ? GenericKeychainCrackerImplementationCXX : GenericKeychainCrackerImplementationObjectiveC;
     
-    if( passwords.count == 0 || ( passwords.count == 1 && passwords.firstObject.length == 0 ) )
+    if( [ @[ @"kcwl", @"gz", @"kcmk" ] containsObject: self.wordList.pathExtension ] )
     {
-        [ self displayAlertWithTitle: @"Error" message: @"Error reading from the word list file." ];
+        self.cracker = [ [ GenericKeychainCracker alloc ] initWithKeychain: self.keychain wordList: self.wordList implementation: imp ];
+    }
+    else
+    {
+        data      = [ [ NSFileManager defaultManager ] contentsAtPath: self.wordList ];
+        passwords = [ [ [ NSString alloc ] initWithData: data encoding: NSUTF8StringEncoding ] componentsSeparatedByString: @"\n" ];
         
-        return;
+        if( passwords.count == 0 || ( passwords.count == 1 && passwords.firstObject.length == 0 ) )
+        {
+            [ self displayAlertWithTitle: @"Error" message: @"Error reading from the word list file." ];
+            
+            return;
+        }
+        
+        self.cracker = [ [ GenericKeychainCracker alloc ] initWithKeychain: self.keychain passwords: passwords implementation: imp ];
     }
     
-    imp                     = ( self.useCPPImplementation ) ? GenericKeychainCrackerImplementationCXX : GenericKeychainCrackerImplementationObjectiveC;
-    self.cracker            = [ [ GenericKeychainCracker alloc ] initWithKeychain: self.keychain passwords: passwords implementation: imp ];
     self.cracker.maxThreads = ( self.numberOfThreads ) ? ( NSUInteger )( self.numberOfThreads ) : 1;
     
+    if( [ self.cracker isKindOfClass: [ GenericKeychainCracker class ] ] )
+    {
+        ( ( GenericKeychainCracker * )( self.cracker ) ).adaptiveThreads = self.adaptiveThreads;
+        ( ( GenericKeychainCracker * )( self.cracker ) ).traceFile       = [ [ NSUserDefaults standardUserDefaults ] stringForKey: @"TraceFile" ];
+        
+        if( [ self applyHybridMask: ( GenericKeychainCracker * )( self.cracker ) ] == NO )
+        {
+            self.cracker = nil;
+            
+            [ self displayAlertWithTitle: @"Error" message: @"Invalid hybrid mask." ];
+            
+            return;
+        }
+        
+        [ self applyMarkovSettings: ( GenericKeychainCracker * )( self.cracker ) ];
+        
+        if( [ self applyConstraints: ( GenericKeychainCracker * )( self.cracker ) ] == NO )
+        {
+            self.cracker = nil;
+            
+            [ self displayAlertWithTitle: @"Error" message: @"Invalid password constraints." ];
+            
+            return;
+        }
+        
+        if( [ [ NSUserDefaults standardUserDefaults ] objectForKey: @"DeduplicationMemory" ] != nil )
+        {
+            ( ( GenericKeychainCracker * )( self.cracker ) ).deduplicationMemory = ( NSUInteger )[ [ NSUserDefaults standardUserDefaults ] integerForKey: @"DeduplicationMemory" ] * 1024 * 1024;
+        }
+    }
+    
     if( self.caseVariants && self.caseVariantsMax > 0 )
     {
         self.cracker.maxCharsForCaseVariants = ( NSUInteger )( self.caseVariantsMax );
@@ -256,6 +302,10 @@ NS_ASSUME_NONNULL_END
                         {
                             [ self displayAlertWithTitle: @"Password found" message: [ NSString stringWithFormat: @"The keychain password is: %@", password ] ];
                         }
+                        else if( [ self.cracker isKindOfClass: [ GenericKeychainCracker class ] ] && ( ( GenericKeychainCracker * )( self.cracker ) ).error != nil )
+                        {
+                            [ self displayAlertWithTitle: @"Error" message: ( ( GenericKeychainCracker * )( self.cracker ) ).error ];
+                        }
                         else
                         {
                             [ self displayAlertWithTitle: @"Password not found" message: @"A correct keychain password wasn't found in the supplied word list." ];
@@ -324,7 +374,7 @@ NS_ASSUME_NONNULL_END
     panel.canChooseDirectories    = NO;
     panel.canChooseFiles          = YES;
     panel.allowsMultipleSelection = NO;
-    panel.allowedFileTypes        = @[ @"txt" ];
+    panel.allowedFileTypes        = @[ @"txt", @"kcwl", @"gz", @"kcmk" ];
     
     [ panel beginSheetModalForWindow: self.window completionHandler: ^( NSInteger result )
         {
@@ -352,6 +402,67 @@ NS_ASSUME_NONNULL_END
     ( void )sender;
 }
 
+- ( BOOL )applyHybridMask: ( GenericKeychainCracker * )cracker
+{
+    NSString * mask;
+    NSString * mode;
+    
+    mask = [ [ NSUserDefaults standardUserDefaults ] stringForKey: @"HybridMask" ];
+    mode = [ [ NSUserDefaults standardUserDefaults ] stringForKey: @"HybridMode" ];
+    
+    if( mask.length == 0 )
+    {
+        return YES;
+    }
+    
+    if( [ mode isEqualToString: @"prepend" ] )
+    {
+        return [ cracker setHybridMask: mask mode: GenericKeychainCrackerHybridModePrepend ];
+    }
+    
+    return [ cracker setHybridMask: mask mode: GenericKeychainCrackerHybridModeAppend ];
+}
+
+- ( void )applyMarkovSettings: ( GenericKeychainCracker * )cracker
+{
+    NSUserDefaults * defaults;
+    
+    defaults = [ NSUserDefaults standardUserDefaults ];
+    
+    if( [ defaults integerForKey: @"MarkovMinLength" ] > 0 )
+    {
+        cracker.markovMinLength = ( NSUInteger )[ defaults integerForKey: @"MarkovMinLength" ];
+    }
+    
+    if( [ defaults integerForKey: @"MarkovMaxLength" ] > 0 )
+    {
+        cracker.markovMaxLength = ( NSUInteger )[ defaults integerForKey: @"MarkovMaxLength" ];
+    }
+    
+    if( [ defaults integerForKey: @"MarkovThreshold" ] > 0 )
+    {
+        cracker.markovThreshold = ( NSUInteger )[ defaults integerForKey: @"MarkovThreshold" ];
+    }
+}
+
+- ( BOOL )applyConstraints: ( GenericKeychainCracker * )cracker
+{
+    NSUserDefaults * defaults;
+    NSInteger        min;
+    NSInteger        max;
+    
+    defaults = [ NSUserDefaults standardUserDefaults ];
+    min      = [ defaults integerForKey: @"ConstraintMinLength" ];
+    max      = [ defaults integerForKey: @"ConstraintMaxLength" ];
+    
+    if( min < 0 || max < 0 )
+    {
+        return NO;
+    }
+    
+    return [ cracker setConstraintsWithMinLength: ( NSUInteger )min maxLength: ( NSUInteger )max required: [ defaults stringForKey: @"ConstraintRequired" ] forbidden: [ defaults stringForKey: @"ConstraintForbidden" ] prefix: [ defaults stringForKey: @"ConstraintPrefix" ] suffix: [ defaults stringForKey: @"ConstraintSuffix" ] pattern: [ defaults stringForKey: @"ConstraintPattern" ] ];
+}
+
 - ( void )displayAlertWithTitle: ( NSString * )title message: ( NSString * )message
 {
     dispatch_async
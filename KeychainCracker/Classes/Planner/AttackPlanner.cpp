@@ -0,0 +1,605 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        AttackPlanner.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "AttackPlanner.hpp"
+#include "RunJournal.hpp"
+#include "KeychainCracker.hpp"
+#include "CompiledWordList.hpp"
+#include "WordListStream.hpp"
+#include "MarkovModel.hpp"
+#include "MarkovSource.hpp"
+#include "Mask.hpp"
+#include "PasswordVariants.hpp"
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <stdexcept>
+#include <random>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <ctime>
+
+namespace XS
+{
+    static const double AttackPlannerDefaultPrior = 0.1;
+    static const double AttackPlannerPriorWeight  = 4.0;
+    static const size_t AttackPlannerSampleSize   = 4096;
+    static const int    AttackPlannerLogInterval  = 30;
+    
+    class AttackPlanner::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & keychain, const std::string & plan, RunJournal & journal );
+            
+            void   parse( const std::string & plan );
+            void   estimate( Attack & attack ) const;
+            double variants( const Attack & attack, const std::string & word ) const;
+            double rate( const Attack & attack ) const;
+            bool   run( const Attack & attack, double budget, std::string & password );
+            void   log( const std::string & message ) const;
+            
+            std::string                                  _keychain;
+            RunJournal                                 & _journal;
+            std::vector< Attack >                        _attacks;
+            std::set< std::string >                      _done;
+            size_t                                       _maxThreads;
+            uint64_t                                     _sessionTried;
+            double                                       _sessionSeconds;
+            std::function< void( const std::string & ) > _logger;
+            mutable std::recursive_mutex                 _rmtx;
+    };
+    
+    AttackPlanner::AttackPlanner( const std::string & keychain, const std::string & plan, RunJournal & journal ):
+        impl( new IMPL( keychain, plan, journal ) )
+    {}
+    
+    AttackPlanner::~AttackPlanner( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( AttackPlanner & o1, AttackPlanner & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    size_t AttackPlanner::maxThreads( void ) const
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        
+        return this->impl->_maxThreads;
+    }
+    
+    void AttackPlanner::maxThreads( size_t value )
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        
+        this->impl->_maxThreads = std::max( value, static_cast< size_t >( 1 ) );
+    }
+    
+    void AttackPlanner::logger( const std::function< void( const std::string & ) > & log )
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        
+        this->impl->_logger = log;
+    }
+    
+    std::vector< AttackPlanner::Attack > AttackPlanner::schedule( void ) const
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_rmtx );
+        std::vector< Attack >                   attacks;
+        RunJournal::Statistics                  stats;
+        
+        for( auto attack: this->impl->_attacks )
+        {
+            if( this->impl->_done.count( attack.name ) > 0 )
+            {
+                continue;
+            }
+            
+            stats              = this->impl->_journal.statistics( attack.name );
+            attack.probability = ( static_cast< double >( stats.hits ) + AttackPlannerPriorWeight * attack.prior ) / ( stats.runs + AttackPlannerPriorWeight );
+            attack.rate        = this->impl->rate( attack );
+            attack.seconds     = ( attack.rate > 0 ) ? static_cast< double >( attack.keyspace ) / attack.rate : 0;
+            
+            attacks.push_back( attack );
+        }
+        
+        std::stable_sort
+        (
+            attacks.begin(),
+            attacks.end(),
+            []( const Attack & a1, const Attack & a2 )
+            {
+                double c1;
+                double c2;
+                
+                c1 = ( a1.rate > 0 ) ? a1.seconds : static_cast< double >( a1.keyspace );
+                c2 = ( a2.rate > 0 ) ? a2.seconds : static_cast< double >( a2.keyspace );
+                
+                return a1.probability * c2 > a2.probability * c1;
+            }
+        );
+        
+        return attacks;
+    }
+    
+    double AttackPlanner::chance( const std::vector< Attack > & schedule, double budget ) const
+    {
+        double miss;
+        
+        miss = 1;
+        
+        for( const auto & attack: schedule )
+        {
+            if( budget <= 0 )
+            {
+                break;
+            }
+            
+            if( attack.rate <= 0 )
+            {
+                return 0;
+            }
+            
+            miss   *= 1 - attack.probability * ( ( attack.seconds > budget ) ? budget / attack.seconds : 1 );
+            budget -= attack.seconds;
+        }
+        
+        return 1 - miss;
+    }
+    
+    bool AttackPlanner::run( double budget, std::string & password )
+    {
+        std::chrono::steady_clock::time_point start;
+        std::vector< Attack >                 attacks;
+        double                                remaining;
+        std::ostringstream                    message;
+        
+        start = std::chrono::steady_clock::now();
+        
+        while( true )
+        {
+            remaining = budget - std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+            attacks   = this->schedule();
+            
+            if( attacks.empty() )
+            {
+                this->impl->log( "All attacks done" );
+                
+                return false;
+            }
+            
+            if( remaining <= 0 )
+            {
+                this->impl->log( "Time budget exhausted" );
+                
+                return false;
+            }
+            
+            message.str( "" );
+            
+            message << "Running " << attacks.front().name
+                    << " (" << attacks.front().keyspace << " candidates"
+                    << ", P = " << attacks.front().probability;
+            
+            if( attacks.front().rate > 0 )
+            {
+                message << ", ~" << static_cast< unsigned long >( attacks.front().seconds ) << " s"
+                        << ", chance of a hit in the remaining " << static_cast< unsigned long >( remaining ) << " s: " << this->chance( attacks, remaining );
+            }
+            
+            message << ")";
+            
+            this->impl->log( message.str() );
+            
+            if( this->impl->run( attacks.front(), remaining, password ) )
+            {
+                return true;
+            }
+        }
+    }
+    
+    AttackPlanner::IMPL::IMPL( const std::string & keychain, const std::string & plan, RunJournal & journal ):
+        _keychain(       keychain ),
+        _journal(        journal ),
+        _maxThreads(     std::max( std::thread::hardware_concurrency(), 1U ) ),
+        _sessionTried(   0 ),
+        _sessionSeconds( 0 )
+    {
+        this->parse( plan );
+        
+        for( auto & attack: this->_attacks )
+        {
+            this->estimate( attack );
+        }
+    }
+    
+    void AttackPlanner::IMPL::parse( const std::string & plan )
+    {
+        std::ifstream           stream( plan );
+        std::string             line;
+        std::string             dir;
+        size_t                  number;
+        std::set< std::string > names;
+        
+        if( stream.good() == false )
+        {
+            throw std::runtime_error( "Cannot open plan " + plan );
+        }
+        
+        dir    = ( plan.rfind( '/' ) != std::string::npos ) ? plan.substr( 0, plan.rfind( '/' ) + 1 ) : "";
+        number = 0;
+        
+        while( std::getline( stream, line ) )
+        {
+            std::istringstream fields( line.substr( 0, line.find( '#' ) ) );
+            std::string        option;
+            std::string        key;
+            std::string        value;
+            Attack             attack;
+            
+            number++;
+            
+            attack.maxCharsForCaseVariants        = 0;
+            attack.maxCharsForCommonSubstitutions = 0;
+            attack.prepend                        = false;
+            attack.markovMinLength                = 1;
+            attack.markovMaxLength                = 8;
+            attack.markovThreshold                = 40;
+            attack.prior                          = AttackPlannerDefaultPrior;
+            attack.keyspace                       = 0;
+            attack.probability                    = 0;
+            attack.rate                           = 0;
+            attack.seconds                        = 0;
+            
+            if( ( fields >> attack.name ).fail() )
+            {
+                continue;
+            }
+            
+            if( ( fields >> attack.wordList ).fail() )
+            {
+                throw std::runtime_error( "Missing word list on line " + std::to_string( number ) + " of " + plan );
+            }
+            
+            if( names.insert( attack.name ).second == false )
+            {
+                throw std::runtime_error( "Duplicate attack " + attack.name + " on line " + std::to_string( number ) + " of " + plan );
+            }
+            
+            if( attack.wordList[ 0 ] != '/' )
+            {
+                attack.wordList = dir + attack.wordList;
+            }
+            
+            while( ( fields >> option ).fail() == false )
+            {
+                key   = option.substr( 0, option.find( '=' ) );
+                value = ( option.find( '=' ) != std::string::npos ) ? option.substr( option.find( '=' ) + 1 ) : "";
+                
+                try
+                {
+                    if( key == "case" )
+                    {
+                        attack.maxCharsForCaseVariants = std::stoul( value );
+                    }
+                    else if( key == "subst" )
+                    {
+                        attack.maxCharsForCommonSubstitutions = std::stoul( value );
+                    }
+                    else if( key == "append" || key == "prepend" )
+                    {
+                        attack.mask    = value;
+                        attack.prepend = key == "prepend";
+                        
+                        Mask mask( value );
+                    }
+                    else if( key == "length" )
+                    {
+                        attack.markovMinLength = std::stoul( value.substr( 0, value.find( '-' ) ) );
+                        attack.markovMaxLength = ( value.find( '-' ) != std::string::npos ) ? std::stoul( value.substr( value.find( '-' ) + 1 ) ) : attack.markovMinLength;
+                    }
+                    else if( key == "threshold" )
+                    {
+                        attack.markovThreshold = static_cast< unsigned int >( std::stoul( value ) );
+                    }
+                    else if( key == "prior" )
+                    {
+                        attack.prior = std::stod( value );
+                        
+                        if( attack.prior < 0 || attack.prior > 1 )
+                        {
+                            throw std::out_of_range( value );
+                        }
+                    }
+                    else
+                    {
+                        throw std::invalid_argument( key );
+                    }
+                }
+                catch( const std::exception & )
+                {
+                    throw std::runtime_error( "Invalid option " + option + " on line " + std::to_string( number ) + " of " + plan );
+                }
+            }
+            
+            this->_attacks.push_back( attack );
+        }
+    }
+    
+    void AttackPlanner::IMPL::estimate( Attack & attack ) const
+    {
+        std::vector< std::string > sample;
+        uint64_t                   words;
+        double                     factor;
+        size_t                     i;
+        
+        if( MarkovModel::isMarkovModel( attack.wordList ) )
+        {
+            MarkovModel  model( attack.wordList );
+            MarkovSource source( model, attack.markovMinLength, attack.markovMaxLength, attack.markovThreshold );
+            
+            attack.keyspace = source.count();
+            
+            return;
+        }
+        
+        if( CompiledWordList::isCompiledWordList( attack.wordList ) )
+        {
+            CompiledWordList list( attack.wordList );
+            
+            words = list.count();
+            
+            for( i = 0; i < list.count(); i += std::max( list.count() / AttackPlannerSampleSize, static_cast< size_t >( 1 ) ) )
+            {
+                sample.push_back( list.string( i ) );
+            }
+        }
+        else
+        {
+            WordListStream   stream( attack.wordList );
+            CandidateBatch   batch;
+            std::minstd_rand random;
+            size_t           j;
+            
+            words = 0;
+            
+            stream.restart();
+            
+            while( stream.next( batch, 4096 ) )
+            {
+                for( i = 0; i < batch.count(); i++, words++ )
+                {
+                    if( sample.size() < AttackPlannerSampleSize )
+                    {
+                        sample.push_back( std::string( batch.candidate( i ), batch.length( i ) ) );
+                        
+                        continue;
+                    }
+                    
+                    j = static_cast< size_t >( random() % ( words + 1 ) );
+                    
+                    if( j < AttackPlannerSampleSize )
+                    {
+                        sample[ j ] = std::string( batch.candidate( i ), batch.length( i ) );
+                    }
+                }
+            }
+            
+            if( stream.error().length() > 0 )
+            {
+                throw std::runtime_error( stream.error() );
+            }
+        }
+        
+        factor = 0;
+        
+        for( const auto & word: sample )
+        {
+            factor += this->variants( attack, word );
+        }
+        
+        factor          = ( sample.empty() ) ? 0 : factor / static_cast< double >( sample.size() );
+        attack.keyspace = static_cast< uint64_t >( std::llround( static_cast< double >( words ) * factor ) );
+        
+        if( attack.mask.length() > 0 )
+        {
+            attack.keyspace *= Mask( attack.mask ).count();
+        }
+    }
+    
+    double AttackPlanner::IMPL::variants( const Attack & attack, const std::string & word ) const
+    {
+        if( attack.maxCharsForCaseVariants == 0 && attack.maxCharsForCommonSubstitutions == 0 )
+        {
+            return 1;
+        }
+        
+        return static_cast< double >( PasswordVariants::count( word.data(), word.length(), attack.maxCharsForCaseVariants, attack.maxCharsForCommonSubstitutions ) );
+    }
+    
+    double AttackPlanner::IMPL::rate( const Attack & attack ) const
+    {
+        RunJournal::Statistics own;
+        RunJournal::Statistics all;
+        double                 speed;
+        
+        own   = this->_journal.statistics( attack.name );
+        all   = this->_journal.statistics();
+        speed = 1;
+        
+        if( this->_sessionSeconds > 0 && this->_sessionTried > 0 && all.seconds > 0 && all.tried > 0 )
+        {
+            speed = ( static_cast< double >( this->_sessionTried ) / this->_sessionSeconds ) / ( static_cast< double >( all.tried ) / all.seconds );
+        }
+        
+        if( own.seconds > 0 && own.tried > 0 )
+        {
+            return speed * static_cast< double >( own.tried ) / own.seconds;
+        }
+        
+        if( all.seconds > 0 && all.tried > 0 )
+        {
+            return speed * static_cast< double >( all.tried ) / all.seconds;
+        }
+        
+        return 0;
+    }
+    
+    bool AttackPlanner::IMPL::run( const Attack & attack, double budget, std::string & password )
+    {
+        std::mutex                            mtx;
+        std::condition_variable               cv;
+        bool                                  done;
+        bool                                  found;
+        bool                                  stopped;
+        std::chrono::steady_clock::time_point start;
+        double                                seconds;
+        int                                   ticks;
+        RunJournal::Entry                     entry;
+        
+        done    = false;
+        found   = false;
+        stopped = false;
+        ticks   = 0;
+        start   = std::chrono::steady_clock::now();
+        seconds = 0;
+        
+        KeychainCracker cracker( this->_keychain, attack.wordList );
+        
+        cracker.maxThreads( this->_maxThreads );
+        cracker.adaptiveThreads( true );
+        cracker.maxCharsForCaseVariants( attack.maxCharsForCaseVariants );
+        cracker.maxCharsForCommonSubstitutions( attack.maxCharsForCommonSubstitutions );
+        cracker.markovLength( attack.markovMinLength, attack.markovMaxLength );
+        cracker.markovThreshold( attack.markovThreshold );
+        
+        if( attack.mask.length() > 0 )
+        {
+            cracker.hybridMask( attack.mask, ( attack.prepend ) ? KeychainCracker::HybridModePrepend : KeychainCracker::HybridModeAppend );
+        }
+        
+        cracker.crack
+        (
+            [ & ]( bool result, const std::string & value )
+            {
+                std::lock_guard< std::mutex > l( mtx );
+                
+                done     = true;
+                found    = result;
+                password = value;
+                
+                cv.notify_all();
+            }
+        );
+        
+        while( true )
+        {
+            {
+                std::unique_lock< std::mutex > l( mtx );
+                
+                if( cv.wait_for( l, std::chrono::seconds( 1 ), [ & ]{ return done; } ) )
+                {
+                    break;
+                }
+            }
+            
+            seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+            
+            if( seconds >= budget && stopped == false )
+            {
+                stopped = true;
+                
+                this->log( "Time budget exhausted during " + attack.name );
+                cracker.stop();
+            }
+            else if( ++ticks % AttackPlannerLogInterval == 0 )
+            {
+                this->log( attack.name + ": " + cracker.message() );
+            }
+        }
+        
+        seconds        = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+        entry.time     = time( nullptr );
+        entry.attack   = attack.name;
+        entry.tried    = cracker.candidatesTried();
+        entry.keyspace = ( stopped || found ) ? std::max( attack.keyspace, entry.tried ) : entry.tried;
+        entry.seconds  = seconds;
+        entry.found    = found;
+        
+        {
+            std::lock_guard< std::recursive_mutex > l( this->_rmtx );
+            
+            this->_sessionTried   += entry.tried;
+            this->_sessionSeconds += seconds;
+            
+            this->_done.insert( attack.name );
+        }
+        
+        if( cracker.error().empty() == false )
+        {
+            this->log( attack.name + ": " + cracker.error() );
+            
+            return false;
+        }
+        
+        try
+        {
+            this->_journal.append( entry );
+        }
+        catch( const std::exception & e )
+        {
+            this->log( e.what() );
+        }
+        
+        this->log( attack.name + ": " + std::to_string( entry.tried ) + " candidates in " + std::to_string( static_cast< unsigned long >( seconds ) ) + " s" + ( ( found ) ? ", password found" : "" ) );
+        
+        return found;
+    }
+    
+    void AttackPlanner::IMPL::log( const std::string & message ) const
+    {
+        std::lock_guard< std::recursive_mutex > l( this->_rmtx );
+        
+        if( this->_logger != nullptr )
+        {
+            this->_logger( message );
+        }
+    }
+}
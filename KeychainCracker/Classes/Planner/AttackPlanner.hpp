@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      AttackPlanner.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_ATTACK_PLANNER_HPP
+#define XS_ATTACK_PLANNER_HPP
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+namespace XS
+{
+    class RunJournal;
+    
+    /*!
+     * Orders and runs a set of attacks within a time budget.
+     * 
+     * Every attack gets an estimated keyspace, a probability of containing
+     * the password and a throughput. The probability starts from the prior
+     * of the plan and is updated with the hits and misses recorded in the
+     * journal. The throughput is the one measured for that attack in past
+     * runs, scaled by how fast this machine has been in the current session.
+     * 
+     * Attacks run by decreasing probability per second, which maximizes the
+     * chance of a hit when the last attack may be cut short by the budget.
+     * The schedule is recomputed after every attack, with the throughput
+     * measured so far.
+     * 
+     * Plan files list one attack per line, as a unique name, a word list
+     * (text, gzip, .kcwl or .kcmk) and options:
+     * 
+     *     case=<n> subst=<n> append=<mask> prepend=<mask>
+     *     length=<min>-<max> threshold=<n> prior=<p>
+     */
+    class AttackPlanner
+    {
+        public:
+            
+            struct Attack
+            {
+                std::string  name;
+                std::string  wordList;
+                size_t       maxCharsForCaseVariants;
+                size_t       maxCharsForCommonSubstitutions;
+                std::string  mask;
+                bool         prepend;
+                size_t       markovMinLength;
+                size_t       markovMaxLength;
+                unsigned int markovThreshold;
+                double       prior;
+                uint64_t     keyspace;
+                double       probability;
+                double       rate;
+                double       seconds;
+            };
+            
+            AttackPlanner( const std::string & keychain, const std::string & plan, RunJournal & journal );
+            ~AttackPlanner( void );
+            
+            AttackPlanner( const AttackPlanner & o )      = delete;
+            AttackPlanner( AttackPlanner && o )           = delete;
+            AttackPlanner & operator =( AttackPlanner o ) = delete;
+            
+            friend void swap( AttackPlanner & o1, AttackPlanner & o2 );
+            
+            size_t maxThreads( void ) const;
+            void   maxThreads( size_t value );
+            void   logger( const std::function< void( const std::string & ) > & log );
+            
+            std::vector< Attack > schedule( void )                                   const;
+            double                chance( const std::vector< Attack > & schedule, double budget ) const;
+            bool                  run( double budget, std::string & password );
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_ATTACK_PLANNER_HPP */
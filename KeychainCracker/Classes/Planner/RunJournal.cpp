@@ -0,0 +1,215 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        RunJournal.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "RunJournal.hpp"
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <sys/stat.h>
+
+namespace XS
+{
+    class RunJournal::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & path );
+            
+            std::vector< Entry > read( void )                           const;
+            Statistics           statistics( const std::string * attack ) const;
+            
+            std::string        _path;
+            mutable std::mutex _mtx;
+    };
+    
+    RunJournal::RunJournal( const std::string & path ):
+        impl( new IMPL( path ) )
+    {}
+    
+    RunJournal::~RunJournal( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( RunJournal & o1, RunJournal & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    std::string RunJournal::defaultPath( void )
+    {
+        const char * home;
+        
+        home = getenv( "HOME" );
+        
+        if( home == nullptr || home[ 0 ] == 0 )
+        {
+            return "KeychainCracker.journal";
+        }
+        
+        return std::string( home ) + "/Library/Application Support/KeychainCracker/Journal.tsv";
+    }
+    
+    std::string RunJournal::path( void ) const
+    {
+        return this->impl->_path;
+    }
+    
+    std::vector< RunJournal::Entry > RunJournal::entries( void ) const
+    {
+        return this->impl->read();
+    }
+    
+    RunJournal::Statistics RunJournal::statistics( const std::string & attack ) const
+    {
+        return this->impl->statistics( &attack );
+    }
+    
+    RunJournal::Statistics RunJournal::statistics( void ) const
+    {
+        return this->impl->statistics( nullptr );
+    }
+    
+    void RunJournal::append( const Entry & entry )
+    {
+        std::string dir;
+        size_t      pos;
+        
+        if( entry.attack.empty() || entry.attack.find_first_of( " \t\r\n" ) != std::string::npos )
+        {
+            throw std::runtime_error( "Invalid attack name: " + entry.attack );
+        }
+        
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        
+        pos = this->impl->_path.rfind( '/' );
+        
+        if( pos != std::string::npos && pos > 0 )
+        {
+            dir = this->impl->_path.substr( 0, pos );
+            
+            mkdir( dir.c_str(), 0700 );
+        }
+        
+        std::ofstream stream( this->impl->_path, std::ios::app );
+        
+        if( stream.good() == false )
+        {
+            throw std::runtime_error( "Cannot write to journal " + this->impl->_path );
+        }
+        
+        stream << static_cast< long long >( entry.time ) << '\t'
+               << entry.attack                           << '\t'
+               << entry.keyspace                         << '\t'
+               << entry.tried                            << '\t'
+               << entry.seconds                          << '\t'
+               << ( ( entry.found ) ? 1 : 0 )            << '\n';
+    }
+    
+    RunJournal::IMPL::IMPL( const std::string & path ):
+        _path( path )
+    {}
+    
+    std::vector< RunJournal::Entry > RunJournal::IMPL::read( void ) const
+    {
+        std::lock_guard< std::mutex > l( this->_mtx );
+        std::vector< Entry >          entries;
+        std::ifstream                 stream( this->_path );
+        std::string                   line;
+        
+        while( std::getline( stream, line ) )
+        {
+            std::istringstream fields( line );
+            Entry              entry;
+            long long          time;
+            int                found;
+            
+            if( line.empty() || line[ 0 ] == '#' )
+            {
+                continue;
+            }
+            
+            fields >> time >> entry.attack >> entry.keyspace >> entry.tried >> entry.seconds >> found;
+            
+            if( fields.fail() )
+            {
+                continue;
+            }
+            
+            entry.time  = static_cast< time_t >( time );
+            entry.found = found != 0;
+            
+            entries.push_back( entry );
+        }
+        
+        return entries;
+    }
+    
+    RunJournal::Statistics RunJournal::IMPL::statistics( const std::string * attack ) const
+    {
+        Statistics           stats;
+        std::vector< Entry > entries;
+        
+        stats.runs    = 0;
+        stats.hits    = 0;
+        stats.tried   = 0;
+        stats.seconds = 0;
+        
+        entries = this->read();
+        
+        for( const auto & entry: entries )
+        {
+            if( attack != nullptr && entry.attack != *( attack ) )
+            {
+                continue;
+            }
+            
+            if( entry.found )
+            {
+                stats.hits++;
+                stats.runs += 1;
+            }
+            else if( entry.keyspace > 0 )
+            {
+                stats.runs += std::min( static_cast< double >( entry.tried ) / static_cast< double >( entry.keyspace ), 1.0 );
+            }
+            
+            stats.tried   += entry.tried;
+            stats.seconds += entry.seconds;
+        }
+        
+        return stats;
+    }
+}
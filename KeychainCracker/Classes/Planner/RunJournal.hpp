@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      RunJournal.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_RUN_JOURNAL_HPP
+#define XS_RUN_JOURNAL_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ctime>
+
+namespace XS
+{
+    /*!
+     * Append-only record of past attacks, one tab-separated line per run:
+     * time, attack name, keyspace, candidates tried, seconds and whether
+     * the password was found.
+     * The planner derives hit rates and measured throughput from it.
+     */
+    class RunJournal
+    {
+        public:
+            
+            struct Entry
+            {
+                time_t      time;
+                std::string attack;
+                uint64_t    keyspace;
+                uint64_t    tried;
+                double      seconds;
+                bool        found;
+            };
+            
+            struct Statistics
+            {
+                double        runs;
+                unsigned long hits;
+                uint64_t      tried;
+                double        seconds;
+            };
+            
+            explicit RunJournal( const std::string & path );
+            ~RunJournal( void );
+            
+            RunJournal( const RunJournal & o )      = delete;
+            RunJournal( RunJournal && o )           = delete;
+            RunJournal & operator =( RunJournal o ) = delete;
+            
+            friend void swap( RunJournal & o1, RunJournal & o2 );
+            
+            static std::string defaultPath( void );
+            
+            std::string          path( void )                               const;
+            std::vector< Entry > entries( void )                            const;
+            Statistics           statistics( const std::string & attack )   const;
+            Statistics           statistics( void )                         const;
+            void                 append( const Entry & entry );
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_RUN_JOURNAL_HPP */
@@ -0,0 +1,461 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        CompiledWordList.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "CompiledWordList.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <unordered_set>
+#include <cstring>
+#include <cctype>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace XS
+{
+    static const char     CompiledWordListMagic[ 4 ]  = { 'K', 'C', 'W', 'L' };
+    static const uint32_t CompiledWordListVersion     = 1;
+    static const uint64_t CompiledWordListNormalized  = 1 << 0;
+    static const uint64_t CompiledWordListSorted      = 1 << 1;
+    
+    struct CompiledWordListHeader
+    {
+        char     magic[ 4 ];
+        uint32_t version;
+        uint64_t flags;
+        uint64_t count;
+        uint64_t maxLength;
+        uint64_t offsetsOffset;
+        uint64_t histogramOffset;
+        uint64_t dataOffset;
+        uint64_t dataSize;
+    };
+    
+    class CompiledWordList::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & path );
+            ~IMPL( void );
+            
+            void unmap( void );
+            bool valid( size_t index ) const;
+            bool spans( size_t first, size_t last, size_t length ) const;
+            void walk( std::vector< Run > & runs, size_t first, size_t last ) const;
+            
+            std::string                    _path;
+            int                            _fd;
+            void                         * _map;
+            size_t                         _size;
+            const CompiledWordListHeader * _header;
+            const uint64_t               * _offsets;
+            const uint64_t               * _histogram;
+            const char                   * _data;
+    };
+    
+    CompiledWordList::CompiledWordList( const std::string & path ):
+        impl( new IMPL( path ) )
+    {}
+    
+    CompiledWordList::~CompiledWordList( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( CompiledWordList & o1, CompiledWordList & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    bool CompiledWordList::isCompiledWordList( const std::string & path )
+    {
+        std::ifstream in( path, std::ios::binary );
+        char          magic[ 4 ] = { 0, 0, 0, 0 };
+        
+        if( in.good() == false )
+        {
+            return false;
+        }
+        
+        in.read( magic, sizeof( magic ) );
+        
+        return in.good() && memcmp( magic, CompiledWordListMagic, sizeof( magic ) ) == 0;
+    }
+    
+    CompiledWordList::CompileStatistics CompiledWordList::compile( const std::string & input, const std::string & output, unsigned int options )
+    {
+        std::ifstream              in( input, std::ios::binary );
+        std::ofstream              out;
+        std::vector< std::string > words;
+        std::vector< uint64_t >    histogram;
+        std::string                line;
+        CompiledWordListHeader     header;
+        CompileStatistics          stats;
+        uint64_t                   offset;
+        
+        std::unordered_set< size_t, std::function< size_t( size_t ) >, std::function< bool( size_t, size_t ) > > seen
+        (
+            0,
+            [ & ]( size_t i )
+            {
+                return std::hash< std::string >()( words[ i ] );
+            },
+            [ & ]( size_t i1, size_t i2 )
+            {
+                return words[ i1 ] == words[ i2 ];
+            }
+        );
+        
+        if( in.good() == false )
+        {
+            throw std::runtime_error( std::string( "Cannot open word list " ) + input );
+        }
+        
+        memset( &stats,  0, sizeof( stats ) );
+        memset( &header, 0, sizeof( header ) );
+        
+        while( std::getline( in, line ) )
+        {
+            stats.lines++;
+            
+            if( line.length() > 0 && line[ line.length() - 1 ] == '\r' )
+            {
+                line.erase( line.length() - 1 );
+            }
+            
+            if( options & CompileOptionNormalize )
+            {
+                line.erase( line.begin(), std::find_if( line.begin(), line.end(), []( char c ) { return isspace( static_cast< unsigned char >( c ) ) == 0; } ) );
+                line.erase( std::find_if( line.rbegin(), line.rend(), []( char c ) { return isspace( static_cast< unsigned char >( c ) ) == 0; } ).base(), line.end() );
+                
+                std::transform( line.begin(), line.end(), line.begin(), []( char c ) { return static_cast< char >( tolower( static_cast< unsigned char >( c ) ) ); } );
+            }
+            
+            if( line.length() == 0 )
+            {
+                continue;
+            }
+            
+            words.push_back( line );
+            
+            if( seen.insert( words.size() - 1 ).second == false )
+            {
+                words.pop_back();
+                
+                stats.duplicates++;
+            }
+        }
+        
+        seen.clear();
+        
+        if( options & CompileOptionSortByLength )
+        {
+            std::stable_sort
+            (
+                words.begin(),
+                words.end(),
+                []( const std::string & s1, const std::string & s2 )
+                {
+                    return s1.length() < s2.length();
+                }
+            );
+        }
+        
+        for( const auto & word: words )
+        {
+            if( word.length() >= histogram.size() )
+            {
+                histogram.resize( word.length() + 1, 0 );
+            }
+            
+            histogram[ word.length() ]++;
+            
+            stats.bytes += word.length();
+        }
+        
+        stats.words = words.size();
+        
+        memcpy( header.magic, CompiledWordListMagic, sizeof( header.magic ) );
+        
+        header.version         = CompiledWordListVersion;
+        header.flags           = ( ( options & CompileOptionNormalize )    ? CompiledWordListNormalized : 0 )
+                               | ( ( options & CompileOptionSortByLength ) ? CompiledWordListSorted     : 0 );
+        header.count           = words.size();
+        header.maxLength       = ( histogram.size() > 0 ) ? histogram.size() - 1 : 0;
+        header.offsetsOffset   = sizeof( header );
+        header.histogramOffset = header.offsetsOffset   + ( header.count     + 1 ) * sizeof( uint64_t );
+        header.dataOffset      = header.histogramOffset + ( header.maxLength + 1 ) * sizeof( uint64_t );
+        header.dataSize        = stats.bytes;
+        
+        histogram.resize( header.maxLength + 1, 0 );
+        out.open( output, std::ios::binary | std::ios::trunc );
+        
+        if( out.good() == false )
+        {
+            throw std::runtime_error( std::string( "Cannot create compiled word list " ) + output );
+        }
+        
+        out.write( reinterpret_cast< const char * >( &header ), sizeof( header ) );
+        
+        offset = 0;
+        
+        for( const auto & word: words )
+        {
+            out.write( reinterpret_cast< const char * >( &offset ), sizeof( offset ) );
+            
+            offset += word.length();
+        }
+        
+        out.write( reinterpret_cast< const char * >( &offset ), sizeof( offset ) );
+        out.write( reinterpret_cast< const char * >( histogram.data() ), static_cast< std::streamsize >( histogram.size() * sizeof( uint64_t ) ) );
+        
+        for( const auto & word: words )
+        {
+            out.write( word.data(), static_cast< std::streamsize >( word.length() ) );
+        }
+        
+        out.close();
+        
+        if( out.fail() )
+        {
+            throw std::runtime_error( std::string( "Error writing compiled word list " ) + output );
+        }
+        
+        return stats;
+    }
+    
+    size_t CompiledWordList::count( void ) const
+    {
+        return static_cast< size_t >( this->impl->_header->count );
+    }
+    
+    size_t CompiledWordList::maxLength( void ) const
+    {
+        return static_cast< size_t >( this->impl->_header->maxLength );
+    }
+    
+    bool CompiledWordList::isSortedByLength( void ) const
+    {
+        return ( this->impl->_header->flags & CompiledWordListSorted ) != 0;
+    }
+    
+    bool CompiledWordList::isNormalized( void ) const
+    {
+        return ( this->impl->_header->flags & CompiledWordListNormalized ) != 0;
+    }
+    
+    const char * CompiledWordList::word( size_t index ) const
+    {
+        return ( this->impl->valid( index ) ) ? this->impl->_data + this->impl->_offsets[ index ] : this->impl->_data;
+    }
+    
+    size_t CompiledWordList::length( size_t index ) const
+    {
+        return ( this->impl->valid( index ) ) ? static_cast< size_t >( this->impl->_offsets[ index + 1 ] - this->impl->_offsets[ index ] ) : 0;
+    }
+    
+    std::string CompiledWordList::string( size_t index ) const
+    {
+        return std::string( this->word( index ), this->length( index ) );
+    }
+    
+    std::vector< size_t > CompiledWordList::histogram( void ) const
+    {
+        return std::vector< size_t >( this->impl->_histogram, this->impl->_histogram + this->impl->_header->maxLength + 1 );
+    }
+    
+    std::vector< CompiledWordList::Run > CompiledWordList::runs( size_t begin, size_t end ) const
+    {
+        std::vector< Run > runs;
+        size_t             first;
+        size_t             last;
+        size_t             length;
+        
+        end = std::min( end, this->count() );
+        
+        for( length = 0, first = 0; this->isSortedByLength() && length <= this->maxLength() && first < end; length++ )
+        {
+            last = first + static_cast< size_t >( std::min( this->impl->_histogram[ length ], static_cast< uint64_t >( end - first ) ) );
+            
+            if( last > begin && first < last && this->impl->spans( std::max( first, begin ), last, length ) )
+            {
+                runs.push_back( { std::max( first, begin ), last - std::max( first, begin ), length } );
+            }
+            else if( last > begin && first < last )
+            {
+                this->impl->walk( runs, std::max( first, begin ), last );
+            }
+            
+            first = last;
+        }
+        
+        this->impl->walk( runs, std::max( first, begin ), end );
+        
+        return runs;
+    }
+    
+    CompiledWordList::IMPL::IMPL( const std::string & path ):
+        _path(      path ),
+        _fd(        -1 ),
+        _map(       nullptr ),
+        _size(      0 ),
+        _header(    nullptr ),
+        _offsets(   nullptr ),
+        _histogram( nullptr ),
+        _data(      nullptr )
+    {
+        struct stat st;
+        bool        valid;
+        
+        this->_fd = open( path.c_str(), O_RDONLY );
+        
+        if( this->_fd == -1 || fstat( this->_fd, &st ) != 0 || st.st_size < static_cast< off_t >( sizeof( CompiledWordListHeader ) ) )
+        {
+            this->unmap();
+            
+            throw std::runtime_error( std::string( "Cannot open compiled word list " ) + path );
+        }
+        
+        this->_size = static_cast< size_t >( st.st_size );
+        this->_map  = mmap( nullptr, this->_size, PROT_READ, MAP_SHARED, this->_fd, 0 );
+        
+        if( this->_map == MAP_FAILED )
+        {
+            this->_map = nullptr;
+            
+            this->unmap();
+            
+            throw std::runtime_error( std::string( "Cannot map compiled word list " ) + path );
+        }
+        
+        this->_header    = static_cast< const CompiledWordListHeader * >( this->_map );
+        valid            = memcmp( this->_header->magic, CompiledWordListMagic, sizeof( this->_header->magic ) ) == 0
+                        && this->_header->version         == CompiledWordListVersion
+                        && this->_header->count           <  this->_size
+                        && this->_header->maxLength       <  this->_size
+                        && this->_header->offsetsOffset   <  this->_size
+                        && this->_header->histogramOffset <  this->_size
+                        && this->_header->dataOffset      <= this->_size
+                        && this->_header->dataSize        <= this->_size
+                        && this->_header->offsetsOffset   +  ( this->_header->count     + 1 ) * sizeof( uint64_t ) <= this->_header->histogramOffset
+                        && this->_header->histogramOffset +  ( this->_header->maxLength + 1 ) * sizeof( uint64_t ) <= this->_header->dataOffset
+                        && this->_header->dataOffset      +  this->_header->dataSize <= this->_size;
+        
+        if( valid == false )
+        {
+            this->unmap();
+            
+            throw std::runtime_error( std::string( "Invalid compiled word list " ) + path );
+        }
+        
+        this->_offsets   = reinterpret_cast< const uint64_t * >( static_cast< const char * >( this->_map ) + this->_header->offsetsOffset );
+        this->_histogram = reinterpret_cast< const uint64_t * >( static_cast< const char * >( this->_map ) + this->_header->histogramOffset );
+        this->_data      = static_cast< const char * >( this->_map ) + this->_header->dataOffset;
+        
+        if( this->_offsets[ this->_header->count ] != this->_header->dataSize )
+        {
+            this->unmap();
+            
+            throw std::runtime_error( std::string( "Invalid compiled word list " ) + path );
+        }
+    }
+    
+    CompiledWordList::IMPL::~IMPL( void )
+    {
+        this->unmap();
+    }
+    
+    void CompiledWordList::IMPL::unmap( void )
+    {
+        if( this->_map != nullptr )
+        {
+            munmap( this->_map, this->_size );
+        }
+        
+        if( this->_fd != -1 )
+        {
+            close( this->_fd );
+        }
+        
+        this->_map = nullptr;
+        this->_fd  = -1;
+    }
+    
+    bool CompiledWordList::IMPL::valid( size_t index ) const
+    {
+        return this->_offsets[ index ]     <= this->_offsets[ index + 1 ]
+            && this->_offsets[ index + 1 ] <= this->_header->dataSize
+            && this->_offsets[ index + 1 ] -  this->_offsets[ index ] <= this->_header->maxLength;
+    }
+    
+    bool CompiledWordList::IMPL::spans( size_t first, size_t last, size_t length ) const
+    {
+        uint64_t size;
+        
+        if( this->_offsets[ first ] > this->_offsets[ last ] || this->_offsets[ last ] > this->_header->dataSize )
+        {
+            return false;
+        }
+        
+        size = this->_offsets[ last ] - this->_offsets[ first ];
+        
+        return size % ( last - first ) == 0 && size / ( last - first ) == length;
+    }
+    
+    void CompiledWordList::IMPL::walk( std::vector< Run > & runs, size_t first, size_t last ) const
+    {
+        size_t i;
+        size_t length;
+        
+        for( i = first; i < last; i++ )
+        {
+            if( this->valid( i ) == false )
+            {
+                continue;
+            }
+            
+            length = static_cast< size_t >( this->_offsets[ i + 1 ] - this->_offsets[ i ] );
+            
+            if( runs.size() > 0 && runs.back().length == length && runs.back().first + runs.back().count == i )
+            {
+                runs.back().count++;
+            }
+            else
+            {
+                runs.push_back( { i, 1, length } );
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      CompiledWordList.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_COMPILED_WORD_LIST_HPP
+#define XS_COMPILED_WORD_LIST_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace XS
+{
+    /*!
+     * Memory-mapped view over a word list produced by CompiledWordList::compile.
+     * 
+     * The file holds a header, an offset table (one entry per word, plus a
+     * terminating entry), a histogram of word lengths and the raw word bytes,
+     * without separators.
+     * When the list was sorted by length, words of the same length are stored
+     * contiguously, so a run of N words of length L is a single block of
+     * N * L bytes.
+     * Opening a list only checks the header, so it takes constant time.
+     * Offsets are checked as words are read: a word whose offsets are
+     * inconsistent reads as empty and is left out of runs(), and a
+     * histogram bucket that doesn't match the offsets is split into
+     * per-word runs, so a damaged file can't make readers leave the data.
+     */
+    class CompiledWordList
+    {
+        public:
+            
+            enum CompileOptions: unsigned int
+            {
+                CompileOptionNone         = 0,
+                CompileOptionNormalize    = 1 << 0,
+                CompileOptionSortByLength = 1 << 1
+            };
+            
+            struct Run
+            {
+                size_t first;
+                size_t count;
+                size_t length;
+            };
+            
+            struct CompileStatistics
+            {
+                size_t lines;
+                size_t duplicates;
+                size_t words;
+                size_t bytes;
+            };
+            
+            explicit CompiledWordList( const std::string & path );
+            ~CompiledWordList( void );
+            
+            CompiledWordList( const CompiledWordList & o )      = delete;
+            CompiledWordList( CompiledWordList && o )           = delete;
+            CompiledWordList & operator =( CompiledWordList o ) = delete;
+            
+            friend void swap( CompiledWordList & o1, CompiledWordList & o2 );
+            
+            static bool              isCompiledWordList( const std::string & path );
+            static CompileStatistics compile( const std::string & input, const std::string & output, unsigned int options );
+            
+            size_t count( void )            const;
+            size_t maxLength( void )        const;
+            bool   isSortedByLength( void ) const;
+            bool   isNormalized( void )     const;
+            
+            const char * word( size_t index )   const;
+            size_t       length( size_t index ) const;
+            std::string  string( size_t index ) const;
+            
+            std::vector< size_t > histogram( void )                const;
+            std::vector< Run >    runs( size_t begin, size_t end ) const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_COMPILED_WORD_LIST_HPP */
@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        CompiledWordListSource.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "CompiledWordListSource.hpp"
+#include <atomic>
+#include <algorithm>
+
+namespace XS
+{
+    class CompiledWordListSource::IMPL
+    {
+        public:
+            
+            IMPL( const CompiledWordList & list );
+            
+            const CompiledWordList & _list;
+            std::atomic< size_t >    _cursor;
+    };
+    
+    CompiledWordListSource::CompiledWordListSource( const CompiledWordList & list ):
+        impl( new IMPL( list ) )
+    {}
+    
+    CompiledWordListSource::~CompiledWordListSource( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( CompiledWordListSource & o1, CompiledWordListSource & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    void CompiledWordListSource::restart( void )
+    {
+        this->impl->_cursor = 0;
+    }
+    
+    bool CompiledWordListSource::next( CandidateBatch & batch, size_t max )
+    {
+        size_t begin;
+        size_t end;
+        size_t i;
+        
+        batch.clear();
+        
+        begin = this->impl->_cursor.fetch_add( max );
+        end   = std::min( begin + max, this->impl->_list.count() );
+        
+        if( begin >= end )
+        {
+            return false;
+        }
+        
+        for( const auto & run: this->impl->_list.runs( begin, end ) )
+        {
+            const char * p;
+            
+            p = this->impl->_list.word( run.first );
+            
+            for( i = 0; i < run.count; i++, p += run.length )
+            {
+                batch.addReference( p, run.length );
+            }
+        }
+        
+        return batch.count() > 0;
+    }
+    
+    size_t CompiledWordListSource::count( void ) const
+    {
+        return this->impl->_list.count();
+    }
+    
+    double CompiledWordListSource::progress( void ) const
+    {
+        if( this->impl->_list.count() == 0 )
+        {
+            return 1.0;
+        }
+        
+        return std::min( static_cast< double >( this->impl->_cursor ) / static_cast< double >( this->impl->_list.count() ), 1.0 );
+    }
+    
+    CompiledWordListSource::IMPL::IMPL( const CompiledWordList & list ):
+        _list(   list ),
+        _cursor( 0 )
+    {}
+}
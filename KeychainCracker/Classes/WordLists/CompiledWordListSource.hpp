@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      CompiledWordListSource.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_COMPILED_WORD_LIST_SOURCE_HPP
+#define XS_COMPILED_WORD_LIST_SOURCE_HPP
+
+#include "CandidateSource.hpp"
+#include "CompiledWordList.hpp"
+
+namespace XS
+{
+    class CompiledWordListSource: public CandidateSource
+    {
+        public:
+            
+            explicit CompiledWordListSource( const CompiledWordList & list );
+            ~CompiledWordListSource( void ) override;
+            
+            CompiledWordListSource( const CompiledWordListSource & o )      = delete;
+            CompiledWordListSource( CompiledWordListSource && o )           = delete;
+            CompiledWordListSource & operator =( CompiledWordListSource o ) = delete;
+            
+            friend void swap( CompiledWordListSource & o1, CompiledWordListSource & o2 );
+            
+            void   restart( void )                            override;
+            bool   next( CandidateBatch & batch, size_t max ) override;
+            size_t count( void )                        const override;
+            double progress( void )                     const override;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_COMPILED_WORD_LIST_SOURCE_HPP */
@@ -0,0 +1,585 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @file        WordListStream.cpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "WordListStream.hpp"
+#include "TraceRecorder.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <zlib.h>
+
+namespace XS
+{
+    class WordListStream::IMPL
+    {
+        public:
+            
+            struct Block
+            {
+                std::vector< char > data;
+                size_t              size;
+                size_t              cursor;
+                bool                ready;
+            };
+            
+            IMPL( const std::string & path, size_t bufferSize );
+            ~IMPL( void );
+            
+            void   start( void );
+            void   stop( void );
+            void   read( void );
+            size_t produce( char * out, size_t max );
+            void   fail( const std::string & error );
+            
+            std::string             _path;
+            size_t                  _bufferSize;
+            size_t                  _fileSize;
+            bool                    _compressed;
+            std::thread             _thread;
+            mutable std::mutex      _mtx;
+            std::condition_variable _cv;
+            Block                   _blocks[ 2 ];
+            size_t                  _front;
+            bool                    _eof;
+            bool                    _stopping;
+            std::atomic< size_t >   _bytesRead;
+            TraceRecorder         * _tracer;
+            std::string             _error;
+            FILE                  * _fp;
+            z_stream                _zstream;
+            std::vector< char >     _input;
+            bool                    _inputEOF;
+            bool                    _streamEnd;
+            bool                    _started;
+    };
+    
+    WordListStream::WordListStream( const std::string & path, size_t bufferSize ):
+        impl( new IMPL( path, bufferSize ) )
+    {}
+    
+    WordListStream::~WordListStream( void )
+    {
+        delete this->impl;
+    }
+    
+    void swap( WordListStream & o1, WordListStream & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    bool WordListStream::isCompressed( const std::string & path )
+    {
+        FILE          * fp;
+        unsigned char   head[ 4096 ];
+        unsigned char   out[ 4096 ];
+        size_t          n;
+        z_stream        zstream;
+        int             ret;
+        
+        fp = fopen( path.c_str(), "rb" );
+        
+        if( fp == nullptr )
+        {
+            return false;
+        }
+        
+        n = fread( head, 1, sizeof( head ), fp );
+        
+        fclose( fp );
+        
+        if( n < 2 )
+        {
+            return false;
+        }
+        
+        if( head[ 0 ] == 0x1F && head[ 1 ] == 0x8B )
+        {
+            return true;
+        }
+        
+        if( ( head[ 0 ] & 0x0F ) != Z_DEFLATED || ( head[ 0 ] >> 4 ) > 7 || ( head[ 1 ] & 0x20 ) != 0 || ( head[ 0 ] * 256 + head[ 1 ] ) % 31 != 0 )
+        {
+            return false;
+        }
+        
+        memset( &zstream, 0, sizeof( zstream ) );
+        
+        if( inflateInit( &zstream ) != Z_OK )
+        {
+            return false;
+        }
+        
+        zstream.next_in  = head;
+        zstream.avail_in = static_cast< uInt >( n );
+        
+        do
+        {
+            zstream.next_out  = out;
+            zstream.avail_out = sizeof( out );
+            ret               = inflate( &zstream, Z_NO_FLUSH );
+        }
+        while( ret == Z_OK && zstream.avail_in > 0 );
+        
+        inflateEnd( &zstream );
+        
+        return ret == Z_OK || ret == Z_STREAM_END || ret == Z_BUF_ERROR;
+    }
+    
+    bool WordListStream::isStandardInput( const std::string & path )
+    {
+        return path == "-";
+    }
+    
+    void WordListStream::restart( void )
+    {
+        this->impl->stop();
+        this->impl->start();
+    }
+    
+    bool WordListStream::next( CandidateBatch & batch, size_t max )
+    {
+        std::unique_lock< std::mutex > l( this->impl->_mtx );
+        
+        batch.clear();
+        
+        while( this->impl->_stopping == false )
+        {
+            IMPL::Block & block = this->impl->_blocks[ this->impl->_front ];
+            
+            if( block.ready )
+            {
+                while( batch.count() < max && block.cursor < block.size )
+                {
+                    const char * start;
+                    const char * end;
+                    size_t       length;
+                    
+                    start         = block.data.data() + block.cursor;
+                    end           = static_cast< const char * >( memchr( start, '\n', block.size - block.cursor ) );
+                    length        = ( end == nullptr ) ? block.size - block.cursor : static_cast< size_t >( end - start );
+                    block.cursor += length + 1;
+                    
+                    if( length > 0 && start[ length - 1 ] == '\r' )
+                    {
+                        length--;
+                    }
+                    
+                    if( length > 0 )
+                    {
+                        batch.add( start, length );
+                    }
+                }
+                
+                if( block.cursor >= block.size )
+                {
+                    block.ready         = false;
+                    this->impl->_front ^= 1;
+                    
+                    this->impl->_cv.notify_all();
+                }
+                
+                if( batch.count() > 0 )
+                {
+                    return true;
+                }
+                
+                continue;
+            }
+            
+            if( this->impl->_eof )
+            {
+                break;
+            }
+            
+            this->impl->_cv.wait( l );
+        }
+        
+        return false;
+    }
+    
+    size_t WordListStream::count( void ) const
+    {
+        return 0;
+    }
+    
+    double WordListStream::progress( void ) const
+    {
+        if( this->impl->_fileSize == 0 )
+        {
+            return 0.0;
+        }
+        
+        return static_cast< double >( this->impl->_bytesRead ) / static_cast< double >( this->impl->_fileSize );
+    }
+    
+    void WordListStream::tracer( TraceRecorder * recorder )
+    {
+        this->impl->stop();
+        
+        this->impl->_tracer = recorder;
+    }
+    
+    std::string WordListStream::error( void ) const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        
+        return this->impl->_error;
+    }
+    
+    WordListStream::IMPL::IMPL( const std::string & path, size_t bufferSize ):
+        _path(       path ),
+        _bufferSize( bufferSize ),
+        _fileSize(   0 ),
+        _compressed( WordListStream::isStandardInput( path ) == false && WordListStream::isCompressed( path ) ),
+        _front(      0 ),
+        _eof(        true ),
+        _stopping(   false ),
+        _bytesRead(  0 ),
+        _tracer(     nullptr ),
+        _fp(         nullptr ),
+        _input(      64 * 1024 ),
+        _inputEOF(   false ),
+        _streamEnd(  false ),
+        _started(    false )
+    {
+        FILE * fp;
+        
+        fp = ( WordListStream::isStandardInput( path ) ) ? nullptr : fopen( path.c_str(), "rb" );
+        
+        if( fp == nullptr && WordListStream::isStandardInput( path ) == false )
+        {
+            throw std::runtime_error( std::string( "Cannot open word list " ) + path );
+        }
+        
+        if( fp != nullptr )
+        {
+            fseeko( fp, 0, SEEK_END );
+            
+            this->_fileSize = static_cast< size_t >( ftello( fp ) );
+            
+            fclose( fp );
+        }
+        else
+        {
+            setvbuf( stdin, nullptr, _IOFBF, bufferSize );
+        }
+        
+        for( auto & block: this->_blocks )
+        {
+            block.size   = 0;
+            block.cursor = 0;
+            block.ready  = false;
+        }
+        
+        memset( &( this->_zstream ), 0, sizeof( this->_zstream ) );
+    }
+    
+    WordListStream::IMPL::~IMPL( void )
+    {
+        this->stop();
+    }
+    
+    void WordListStream::IMPL::start( void )
+    {
+        for( auto & block: this->_blocks )
+        {
+            block.size   = 0;
+            block.cursor = 0;
+            block.ready  = false;
+        }
+        
+        this->_front     = 0;
+        this->_eof       = false;
+        this->_stopping  = false;
+        this->_bytesRead = 0;
+        this->_inputEOF  = false;
+        this->_streamEnd = false;
+        this->_error     = "";
+        
+        if( WordListStream::isStandardInput( this->_path ) && this->_started )
+        {
+            this->_eof   = true;
+            this->_error = "The standard input can only be read once";
+            
+            return;
+        }
+        
+        this->_started   = true;
+        this->_fp        = ( WordListStream::isStandardInput( this->_path ) ) ? stdin : fopen( this->_path.c_str(), "rb" );
+        
+        if( this->_fp == nullptr )
+        {
+            this->_eof   = true;
+            this->_error = "Cannot open word list " + this->_path;
+            
+            return;
+        }
+        
+        if( this->_compressed && inflateInit2( &( this->_zstream ), 15 + 32 ) != Z_OK )
+        {
+            fclose( this->_fp );
+            
+            this->_fp    = nullptr;
+            this->_eof   = true;
+            this->_error = "Cannot initialize zlib";
+            
+            return;
+        }
+        
+        this->_thread = std::thread
+        (
+            [ this ]
+            {
+                this->read();
+            }
+        );
+    }
+    
+    void WordListStream::IMPL::stop( void )
+    {
+        {
+            std::lock_guard< std::mutex > l( this->_mtx );
+            
+            this->_stopping = true;
+        }
+        
+        this->_cv.notify_all();
+        
+        if( this->_thread.joinable() )
+        {
+            this->_thread.join();
+        }
+        
+        if( this->_fp != nullptr )
+        {
+            if( this->_fp != stdin )
+            {
+                fclose( this->_fp );
+            }
+            
+            this->_fp = nullptr;
+            
+            if( this->_compressed )
+            {
+                inflateEnd( &( this->_zstream ) );
+                memset( &( this->_zstream ), 0, sizeof( this->_zstream ) );
+            }
+        }
+    }
+    
+    void WordListStream::IMPL::read( void )
+    {
+        std::vector< char > pending;
+        size_t              index;
+        bool                eof;
+        
+        index = 0;
+        eof   = false;
+        
+        if( this->_tracer != nullptr )
+        {
+            this->_tracer->threadName( "Word list reader" );
+        }
+        
+        while( eof == false )
+        {
+            Block                               & block = this->_blocks[ index ];
+            std::vector< char >::reverse_iterator last;
+            
+            {
+                TraceRecorder::Span            span( this->_tracer, "enqueue" );
+                std::unique_lock< std::mutex > l( this->_mtx );
+                
+                this->_cv.wait( l, [ & ]{ return block.ready == false || this->_stopping; } );
+                
+                if( this->_stopping )
+                {
+                    return;
+                }
+            }
+            
+            TraceRecorder::Span span( this->_tracer, "generate batch" );
+            
+            block.data.swap( pending );
+            pending.clear();
+            
+            while( true )
+            {
+                size_t size;
+                size_t n;
+                
+                size = block.data.size();
+                
+                block.data.resize( std::max( size + this->_bufferSize / 4, this->_bufferSize ) );
+                
+                n = this->produce( block.data.data() + size, block.data.size() - size );
+                
+                block.data.resize( size + n );
+                
+                if( n == 0 )
+                {
+                    eof = true;
+                    
+                    break;
+                }
+                
+                if( block.data.size() < this->_bufferSize )
+                {
+                    continue;
+                }
+                
+                if( memchr( block.data.data() + size, '\n', n ) != nullptr )
+                {
+                    break;
+                }
+            }
+            
+            if( eof == false )
+            {
+                last = std::find( block.data.rbegin(), block.data.rend(), '\n' );
+                
+                if( last != block.data.rend() )
+                {
+                    pending.assign( last.base(), block.data.end() );
+                    block.data.erase( last.base(), block.data.end() );
+                }
+            }
+            
+            {
+                std::lock_guard< std::mutex > l( this->_mtx );
+                
+                block.size   = block.data.size();
+                block.cursor = 0;
+                block.ready  = block.size > 0;
+                this->_eof   = eof;
+            }
+            
+            span.count( block.size );
+            
+            this->_cv.notify_all();
+            
+            index ^= 1;
+        }
+    }
+    
+    size_t WordListStream::IMPL::produce( char * out, size_t max )
+    {
+        size_t n;
+        int    ret;
+        
+        if( this->_compressed == false )
+        {
+            n                 = fread( out, 1, max, this->_fp );
+            this->_bytesRead += n;
+            
+            if( ferror( this->_fp ) )
+            {
+                this->fail( "Error reading word list " + this->_path );
+            }
+            
+            return n;
+        }
+        
+        this->_zstream.next_out  = reinterpret_cast< Bytef * >( out );
+        this->_zstream.avail_out = static_cast< uInt >( max );
+        
+        while( this->_zstream.avail_out == max )
+        {
+            if( this->_zstream.avail_in == 0 )
+            {
+                if( this->_inputEOF )
+                {
+                    break;
+                }
+                
+                n                        = fread( this->_input.data(), 1, this->_input.size(), this->_fp );
+                this->_bytesRead        += n;
+                this->_inputEOF          = n < this->_input.size();
+                this->_zstream.next_in   = reinterpret_cast< Bytef * >( this->_input.data() );
+                this->_zstream.avail_in  = static_cast< uInt >( n );
+                
+                if( ferror( this->_fp ) )
+                {
+                    this->fail( "Error reading word list " + this->_path );
+                }
+                
+                if( n == 0 )
+                {
+                    break;
+                }
+            }
+            
+            ret = inflate( &( this->_zstream ), Z_NO_FLUSH );
+            
+            this->_streamEnd = ret == Z_STREAM_END || ( ret == Z_BUF_ERROR && this->_streamEnd );
+            
+            if( ret == Z_STREAM_END )
+            {
+                if( this->_zstream.avail_in == 0 && this->_inputEOF )
+                {
+                    break;
+                }
+                
+                inflateReset( &( this->_zstream ) );
+            }
+            else if( ret != Z_OK && ret != Z_BUF_ERROR )
+            {
+                this->fail( "Error decompressing word list " + this->_path + ( ( this->_zstream.msg != nullptr ) ? std::string( ": " ) + this->_zstream.msg : "" ) );
+                
+                break;
+            }
+        }
+        
+        if( this->_zstream.avail_out == max && this->_zstream.avail_in == 0 && this->_inputEOF && this->_streamEnd == false )
+        {
+            this->fail( "Error decompressing word list " + this->_path + ": unexpected end of file" );
+        }
+        
+        return max - this->_zstream.avail_out;
+    }
+    
+    void WordListStream::IMPL::fail( const std::string & error )
+    {
+        std::lock_guard< std::mutex > l( this->_mtx );
+        
+        if( this->_error.empty() )
+        {
+            this->_error = error;
+        }
+    }
+}
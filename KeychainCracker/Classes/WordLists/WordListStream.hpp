@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2017 Jean-David Gadina - www.xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+/*!
+ * @header      WordListStream.hpp
+ * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef XS_WORD_LIST_STREAM_HPP
+#define XS_WORD_LIST_STREAM_HPP
+
+#include "CandidateSource.hpp"
+#include <string>
+
+namespace XS
+{
+    /*!
+     * Streams a newline-delimited word list, either plain or gzip/zlib
+     * compressed, from a dedicated reader thread.
+     * The reader decompresses into one buffer while workers take lines from
+     * the other, so only two buffers of the uncompressed list are ever held
+     * in memory.
+     * Compressed files are recognized by the gzip magic number, or by a
+     * zlib header whose first bytes also inflate without error.
+     * The path "-" reads the standard input, which is never decompressed
+     * and can only be streamed once: restarting it a second time reports
+     * an error through error() instead of producing nothing.
+     */
+    class WordListStream: public CandidateSource
+    {
+        public:
+            
+            explicit WordListStream( const std::string & path, size_t bufferSize = 1024 * 1024 );
+            ~WordListStream( void ) override;
+            
+            WordListStream( const WordListStream & o )      = delete;
+            WordListStream( WordListStream && o )           = delete;
+            WordListStream & operator =( WordListStream o ) = delete;
+            
+            friend void swap( WordListStream & o1, WordListStream & o2 );
+            
+            static bool isCompressed( const std::string & path );
+            static bool isStandardInput( const std::string & path );
+            
+            void        restart( void )                            override;
+            bool        next( CandidateBatch & batch, size_t max ) override;
+            size_t      count( void )                        const override;
+            double      progress( void )                     const override;
+            void        tracer( TraceRecorder * recorder )         override;
+            std::string error( void )                        const;
+            
+        private:
+            
+            class  IMPL;
+            IMPL * impl;
+    };
+}
+
+#endif /* XS_WORD_LIST_STREAM_HPP */
@@ -23,13 +23,23 @@
  ******************************************************************************/
 
 /*!
- * @header      main.m
+ * @header      main.mm
  * @copyright   (c) 2017, Jean-David Gadina - www.xs-labs.com
  */
 
-@import Cocoa;
+#import <Cocoa/Cocoa.h>
+#import "CommandLine.hpp"
 
 int main( int argc, const char * argv[] )
 {
+    {
+        XS::CommandLine cli( argc, argv );
+        
+        if( cli.isCommand() )
+        {
+            return cli.run();
+        }
+    }
+    
     return NSApplicationMain( argc, argv );
 }